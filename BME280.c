@@ -18,68 +18,372 @@
  ***********************************************************************************/
 
 #include "BME280.h"
+#include <string.h>
 
-static inline CONCAT_BYTES(uint8_t msb, uint8_t lsb) {
+static inline uint16_t CONCAT_BYTES(uint8_t msb, uint8_t lsb) {
     return (uint16_t)(((uint16_t)msb << 8) | (uint16_t)lsb);
 }	
+//PROFILES	==================================================================
+static const bme280_config bme280_profiles[] = {
+	[BME280_PROFILE_DEFAULT] = {BME280_NORMAL_MODE, BME280_TEMP_OVERSAMPLING_16X, BME280_PRESS_OVERSAMPLING_16X,
+			BME280_HUM_OVERSAMPLING_16X, BME280_FILTER_COEFF_16, BME280_STANDBY_TIME_20_MS},
+	[BME280_PROFILE_WEATHER] = {BME280_FORCED_MODE, BME280_TEMP_OVERSAMPLING_1X, BME280_PRESS_OVERSAMPLING_1X,
+			BME280_HUM_OVERSAMPLING_1X, BME280_FILTER_COEFF_OFF, BME280_STANDBY_TIME_0_5_MS},
+	[BME280_PROFILE_HUMIDITY] = {BME280_FORCED_MODE, BME280_TEMP_OVERSAMPLING_1X, BME280_PRESS_OVERSAMPLING_OFF,
+			BME280_HUM_OVERSAMPLING_1X, BME280_FILTER_COEFF_OFF, BME280_STANDBY_TIME_0_5_MS},
+	[BME280_PROFILE_INDOOR_NAV] = {BME280_NORMAL_MODE, BME280_TEMP_OVERSAMPLING_2X, BME280_PRESS_OVERSAMPLING_16X,
+			BME280_HUM_OVERSAMPLING_1X, BME280_FILTER_COEFF_16, BME280_STANDBY_TIME_0_5_MS},
+	[BME280_PROFILE_GAMING] = {BME280_NORMAL_MODE, BME280_TEMP_OVERSAMPLING_1X, BME280_PRESS_OVERSAMPLING_4X,
+			BME280_HUM_OVERSAMPLING_OFF, BME280_FILTER_COEFF_16, BME280_STANDBY_TIME_0_5_MS}
+};
+
+//ctrl_meas value for setup, forced mode waits in sleep until BME280_GetDataForced
+static inline uint8_t ctrl_meas_reg(const bme280_config *cfg) {
+	uint8_t mode = (cfg->mode == BME280_NORMAL_MODE) ? BME280_NORMAL_MODE : BME280_SLEEP_MODE;
+	return mode | cfg->osrs_p | cfg->osrs_t;
+}
+
+//STATISTICS	==================================================================
+#ifdef BME280_STATS
+static uint32_t (*stats_clock)(void);
+
+static inline uint32_t stats_now(void) {
+	return stats_clock ? stats_clock() : 0;
+}
+
+//result of the last transfer, called before the port is used again
+static void stats_port(const I2C_Connection *_i2c, BME280_t *dev) {
+	if (dev->stats.pending) {
+		if (_i2c->status == PORT_ERROR) {
+			dev->stats.errors++;
+			dev->stats.pending = 0;
+		} else if (_i2c->status == PORT_FREE) {
+			dev->stats.pending = 0;
+		}
+	}
+}
+
+static void stats_start(const I2C_Connection *_i2c, BME280_t *dev) {
+	dev->stats.transactions++;
+	dev->stats.bytes += _i2c->len;
+	dev->stats.pending = 1;
+	if (!dev->stats.busy) {
+		dev->stats.busy = 1;
+		dev->stats.op_start = stats_now();
+	}
+}
+
+static void stats_done(BME280_t *dev) {
+	uint32_t lat;
+
+	if (!dev->stats.busy) {
+		return;
+	}
+	lat = stats_now() - dev->stats.op_start;
+	if (dev->stats.ops == 0 || lat < dev->stats.lat_min) {
+		dev->stats.lat_min = lat;
+	}
+	if (lat > dev->stats.lat_max) {
+		dev->stats.lat_max = lat;
+	}
+	dev->stats.lat_sum += lat;
+	dev->stats.ops++;
+	dev->stats.busy = 0;
+}
+
+//error or timeout of the transfer, the operation is dropped
+static void stats_abort(const I2C_Connection *_i2c, BME280_t *dev) {
+	if (dev->stats.pending && _i2c->status != PORT_FREE) {
+		dev->stats.errors++;
+	}
+	dev->stats.pending = 0;
+	dev->stats.busy = 0;
+}
+
+static void stats_comp(BME280_t *dev, uint32_t start) {
+	uint32_t t = stats_now() - start;
+
+	if (t > dev->stats.comp_max) {
+		dev->stats.comp_max = t;
+	}
+	dev->stats.comp_sum += t;
+	dev->stats.comp_count++;
+}
+
+/*!
+ *  @brief This API sets the clock of the time statistics of all sensors,
+ *  e.g. a function returning the DWT cycle counter. NULL stops timing.
+ */
+void BME280_StatsClock(uint32_t (*clock)(void)) {
+	stats_clock = clock;
+}
+
+/*!
+ *  @brief This API copies the statistics of a sensor. Call it from the
+ *  context that runs the driver or with its interrupt masked.
+ */
+void BME280_StatsSnapshot(const BME280_t *dev, bme280_stats *out) {
+	*out = dev->stats;
+}
+
+void BME280_StatsReset(BME280_t *dev) {
+	uint8_t pending = dev->stats.pending;
+	uint8_t busy = dev->stats.busy;
+	uint32_t op_start = dev->stats.op_start;
+
+	memset(&dev->stats, 0, sizeof(dev->stats));
+	dev->stats.pending = pending;
+	dev->stats.busy = busy;
+	dev->stats.op_start = op_start;
+}
+
+#define STATS_PORT(p, d)	stats_port((p), (d))
+#define STATS_START(p, d)	stats_start((p), (d))
+#define STATS_DONE(d)		stats_done(d)
+#define STATS_RETRY(d)		((d)->stats.retries++)
+#define STATS_ABORT(p, d)	stats_abort((p), (d))
+#else
+#define STATS_PORT(p, d)
+#define STATS_START(p, d)
+#define STATS_DONE(d)
+#define STATS_RETRY(d)
+#define STATS_ABORT(p, d)
+#endif
+//TRANSPORT	==================================================================
+static void i2c_start(void *ctx, I2C_Connection *port) {
+	(void)ctx;
+	I2C_Start_IRQ(port);
+}
+
+const bme280_transport bme280_i2c_transport = {BME280_BUS_I2C, i2c_start, 0};
+
+static inline uint8_t is_spi(const BME280_t *dev) {
+	return dev->bus && dev->bus->type != BME280_BUS_I2C;
+}
+
+//register address byte of a write, SPI clears bit 7
+static inline uint8_t reg_wr(const BME280_t *dev, uint8_t reg) {
+	return is_spi(dev) ? (uint8_t)(reg & ~BME280_SPI_READ) : reg;
+}
+
+/*!
+ *  @brief This internal API starts the transfer prepared in the port on
+ *  the bus of the sensor. For SPI the control byte carries the direction
+ *  in bit 7: set to read, cleared to write.
+ */
+static void start_transfer(I2C_Connection *_i2c, BME280_t *dev) {
+	STATS_START(_i2c, dev);
+	if (is_spi(dev)) {
+		if (_i2c->mode == I2C_MODE_READ) {
+			_i2c->reg = (uint8_t)(_i2c->reg | BME280_SPI_READ);
+		} else {
+			_i2c->reg = (uint8_t)(_i2c->reg & ~BME280_SPI_READ);
+		}
+	}
+	if (dev->bus) {
+		dev->bus->start(dev->bus->ctx, _i2c);
+	} else {
+		I2C_Start_IRQ(_i2c);
+	}
+}
 //INITIALIZATION	================================================================
+static inline uint8_t config_reg(const BME280_t *dev) {
+	uint8_t spi3w = (dev->bus && dev->bus->type == BME280_BUS_SPI3) ? BME280_SPI_3WIRE_MODE_ON : BME280_SPI_3WIRE_MODE_OFF;
+	return spi3w | dev->config.filter | dev->config.standby;
+}
+
+/*!
+ *  @brief This internal API prepares the setup write of dev->config, or of
+ *  the register bytes of dev->setup_regs if set.
+ *  The sensor is put to sleep first so the config register write is not
+ *  ignored, then ctrl_hum and ctrl_meas are set. Everything goes in one
+ *  transaction of register address/data pairs.
+ */
+static void put_setup(I2C_Connection *_i2c, BME280_t *dev) {
+	uint8_t dt[7];
+	uint8_t ctrl_hum = dev->config.osrs_h;
+	uint8_t ctrl_meas = ctrl_meas_reg(&dev->config);
+	uint8_t cfg = config_reg(dev);
+
+	if (dev->setup_regs) {
+		ctrl_hum = dev->setup_regs[0];
+		ctrl_meas = dev->setup_regs[1];
+		cfg = dev->setup_regs[2];
+	}
+	dt[0] = ctrl_meas & ~BME280_NORMAL_MODE;
+	dt[1] = reg_wr(dev, BME280_REG_CFG);
+	dt[2] = cfg;
+	dt[3] = reg_wr(dev, BME280_REG_CTRL_HUM);
+	dt[4] = ctrl_hum;
+	dt[5] = reg_wr(dev, BME280_REG_CTRL_MEAS_PWR);
+	dt[6] = ctrl_meas;
+	_i2c->reg = BME280_REG_CTRL_MEAS_PWR;
+	_i2c->len = 7;
+	_i2c->mode = I2C_MODE_WRITE;
+	PutMulti(&_i2c->buffer, dt, 7);
+}
+
+/*!
+ *  @brief This internal API prepares the write of the config register with
+ *  spi3w_en for a 3-wire SPI bus. The sensor starts (and restarts after a
+ *  soft reset) in 4-wire mode and cannot answer a 3-wire read before it.
+ *  Returns 0 and prepares nothing on the other buses.
+ */
+static uint8_t put_spi3w(I2C_Connection *_i2c, BME280_t *dev) {
+	if (!dev->bus || dev->bus->type != BME280_BUS_SPI3) {
+		return 0;
+	}
+	_i2c->reg = BME280_REG_CFG;
+	_i2c->len = 1;
+	_i2c->mode = I2C_MODE_WRITE;
+	PutOne(&_i2c->buffer, (dev->setup_regs ? dev->setup_regs[2] : config_reg(dev)) | BME280_SPI_3WIRE_MODE_ON);
+	return 1;
+}
+
+/*!
+ *  @brief This API loads one of the datasheet recommended settings
+ *  into dev->config. Apply it with BME280_Init or BME280_Configure.
+ */
+void BME280_SetProfile(BME280_t *dev, uint8_t profile) {
+	if (profile > BME280_PROFILE_GAMING) {
+		profile = BME280_PROFILE_DEFAULT;
+	}
+	dev->config = bme280_profiles[profile];
+}
+
+/*!
+ *  @brief This API writes dev->config to the sensor without reading the
+ *  calibration again.
+ */
+uint8_t BME280_Configure(I2C_Connection *_i2c, BME280_t *dev) {
+	STATS_PORT(_i2c, dev);
+	if (_i2c->status == PORT_FREE) {//send setup
+		_i2c->addr = dev->addr;
+		dev->wait_us = 0;
+		if (dev->step == 0) {
+			put_setup(_i2c, dev);
+			dev->step = 1;
+		} else {
+			dev->step = 0;
+			STATS_DONE(dev);
+			return 1;
+		}
+		start_transfer(_i2c, dev);
+	}
+	return 0;
+}
+
 /*!
  *  @brief This API is the entry point.
- *  It reads the chip-id and calibration data from the sensor.
+ *  It waits while the sensor copies its NVM (status im_update), reads the
+ *  calibration data and the chip-id and writes dev->config. If no BME280 answers at the
+ *  address it returns 1 with dev->error set and dev->status not OK.
+ *  With a calibration restored by BME280_RestoreCalib only the status
+ *  poll and the setup write are done. On a 3-wire SPI bus spi3w_en is
+ *  written before the first read.
  */
 uint8_t BME280_Init(I2C_Connection *_i2c, BME280_t *dev) {
+	uint8_t st;
+
+	STATS_PORT(_i2c, dev);
 	if (_i2c->status == PORT_FREE) {//send setup
         _i2c->addr = dev->addr;
+        dev->wait_us = 0;
         switch (dev->step) {
-		case 0://setup humidity
+		case 0://3-wire SPI: enable it before the first read
 			dev->status = INIT;
-			_i2c->reg = BME280_REG_CTRL_HUM;
+			dev->error = BME280_ERR_NONE;
+			if (dev->config.mode == BME280_SLEEP_MODE) {
+				BME280_SetProfile(dev, BME280_PROFILE_DEFAULT);
+			}
+			if (put_spi3w(_i2c, dev)) {
+				dev->step = 1;
+				break;
+			}
+			/* fall through */
+		case 1://wait for the NVM copy, read status
+			_i2c->reg = BME280_REG_STATUS;
 			_i2c->len = 1;
-			_i2c->mode = I2C_MODE_WRITE;
-            PutOne(&_i2c->buffer, BME280_HUM_OVERSAMPLING_16X);
-			dev->step = 1;
-			break;
-		case 1://setup mode temp pressure
-			_i2c->reg = BME280_REG_CTRL_MEAS_PWR;
-			_i2c->len = 2;
-			_i2c->mode = I2C_MODE_WRITE;
-            uint8_t dt[2];
-			dt[0] = BME280_NORMAL_MODE | BME280_PRESS_OVERSAMPLING_16X | BME280_TEMP_OVERSAMPLING_16X;
-			dt[1] = BME280_SPI_3WIRE_MODE_OFF | BME280_FILTER_COEFF_16 | BME280_STANDBY_TIME_20_MS;
-            PutMulti(&_i2c->buffer, dt, 2);
+			_i2c->mode = I2C_MODE_READ;
 			dev->step = 2;
 			break;
-		case 2://read calib temp data
-			_i2c->reg = BME280_REG_T_P_CALIB_DATA;
-			_i2c->len = BME280_T_P_CALIB_DATA_LEN;
+		case 2://read calib temp pressure data or setup when the NVM copy is done
+			GetMulti(&_i2c->buffer, &st, 1);
+			if (st & BME280_STATUS_IM_UPDATE) {
+				STATS_RETRY(dev);
+				_i2c->reg = BME280_REG_STATUS;
+				_i2c->len = 1;
+			} else if (dev->calib_cached) {//calibration restored by BME280_RestoreCalib
+				put_setup(_i2c, dev);
+				dev->step = 5;
+				break;
+			} else {
+				_i2c->reg = BME280_REG_T_P_CALIB_DATA;
+				_i2c->len = BME280_T_P_CALIB_DATA_LEN;
+				dev->step = 3;
+			}
 			_i2c->mode = I2C_MODE_READ;
-			dev->step = 3;
 			break;
-		case 3://read calib pressure data
+		case 3://read chip id and calib humidity data in one block
 			parse_temp_press_calib_data(_i2c, dev);
-			_i2c->reg = BME280_REG_HUM_CALIB_DATA;
-			_i2c->len = BME280_HUM_CALIB_DATA_LEN;
+			_i2c->reg = BME280_REG_CHIP_ID;
+			_i2c->len = BME280_ID_HUM_CALIB_DATA_LEN;
 			_i2c->mode = I2C_MODE_READ;
 			dev->step = 4;
 			break;
-		case 4:
-			parse_humidity_calib_data(_i2c, dev);
+		case 4://check chip id, setup all control registers
+			if (!parse_id_humidity_calib_data(_i2c, dev)) {
+				dev->error = BME280_ERR_CHIP_ID;
+				dev->step = 0;
+				STATS_DONE(dev);
+				return 1;
+			}
+			put_setup(_i2c, dev);
+			dev->step = 5;
+			break;
+		case 5:
+			bme280_prepare_calib_data(dev);
 			dev->status = OK;
             dev->step = 0;
+			STATS_DONE(dev);
 			return 1;
 			break;
 		default:
 			dev->step = 0;
             break;
 		}
-        I2C_Start_IRQ(_i2c);
+        start_transfer(_i2c, dev);
 	}
 	return 0;
 }
 
+/*!
+ *  @brief This API reads one sample in normal mode. The sensor updates the
+ *  data registers once per BME280_CyclePeriod(), a read that returns the
+ *  same frame as the previous one clears dev->fresh, counts in dev->dup_samples
+ *  and is neither logged nor compensated again.
+ */
 uint8_t BME280_GetData(I2C_Connection *_i2c, BME280_t *dev) {
+	if (!BME280_ReadData(_i2c, dev)) {
+		return 0;
+	}
+	if (dev->fresh) {
+		bme280_calculate_data(dev);
+	}
+	return 1;
+}
+
+/*!
+ *  @brief This API is BME280_GetData without the compensation: the new raw
+ *  sample is in dev->uncomp_data with dev->dirty set, the values are taken
+ *  with the getters. It does not link bme280_calculate_data, so with
+ *  --gc-sections only the compensation of the getters called is kept.
+ */
+uint8_t BME280_ReadData(I2C_Connection *_i2c, BME280_t *dev) {
+	STATS_PORT(_i2c, dev);
 	if (_i2c->status == PORT_FREE) {//send setup
         _i2c->addr = dev->addr;
+        dev->wait_us = 0;
         if (dev->step == 0) {
             _i2c->reg = BME280_REG_DATA;
             _i2c->len = BME280_DATA_LEN;
@@ -87,101 +391,614 @@ uint8_t BME280_GetData(I2C_Connection *_i2c, BME280_t *dev) {
             dev->step = 1;
         } else if (dev->step == 1) {
         	bme280_parse_sensor_data(_i2c, dev);
-            bme280_calculate_data_int(dev);
-            bme280_calculate_data_float(dev);
+            if (dev->fresh && dev->on_raw) {
+                dev->on_raw(dev->raw_ctx, &dev->uncomp_data);
+            }
             dev->step = 0;
+            STATS_DONE(dev);
             return 1;
         }
-        I2C_Start_IRQ(_i2c);
+        start_transfer(_i2c, dev);
 	}
 	return 0;
 }
+
+/*!
+ *  @brief This API runs one forced mode measurement: it triggers the
+ *  conversion, waits BME280_MeasureTimeMax() microseconds, reads the status
+ *  and then the data. The waits are steps that start no transfer and set
+ *  dev->wait_us, the port is free meanwhile: call again after that time
+ *  (calling earlier only polls the status sooner). A conversion still
+ *  running is polled every BME280_STATUS_POLL_US. The sensor sleeps
+ *  between measurements.
+ */
+uint8_t BME280_GetDataForced(I2C_Connection *_i2c, BME280_t *dev) {
+	if (!BME280_ReadDataForced(_i2c, dev)) {
+		return 0;
+	}
+	bme280_calculate_data(dev);
+	return 1;
+}
+
+/*!
+ *  @brief This API is BME280_GetDataForced without the compensation, see
+ *  BME280_ReadData.
+ */
+uint8_t BME280_ReadDataForced(I2C_Connection *_i2c, BME280_t *dev) {
+	uint8_t st;
+
+	STATS_PORT(_i2c, dev);
+	if (_i2c->status == PORT_FREE) {//send setup
+		_i2c->addr = dev->addr;
+		dev->wait_us = 0;
+		switch (dev->step) {
+		case 0://start conversion
+			_i2c->reg = BME280_REG_CTRL_MEAS_PWR;
+			_i2c->len = 1;
+			_i2c->mode = I2C_MODE_WRITE;
+			PutOne(&_i2c->buffer, BME280_FORCED_MODE | (dev->setup_regs ? (dev->setup_regs[1] & ~BME280_NORMAL_MODE)
+					: (dev->config.osrs_p | dev->config.osrs_t)));
+			dev->step = 1;
+			break;
+		case 1://wait the conversion time
+			dev->wait_us = BME280_MeasureTimeMax(dev->config.osrs_t, dev->config.osrs_p, dev->config.osrs_h);
+			dev->step = 2;
+			return 0;
+		case 2://read status
+			_i2c->reg = BME280_REG_STATUS;
+			_i2c->len = 1;
+			_i2c->mode = I2C_MODE_READ;
+			dev->step = 3;
+			break;
+		case 3://wait conversion end then read data
+			GetMulti(&_i2c->buffer, &st, 1);
+			if (st & BME280_STATUS_IS_MEASURE) {
+				STATS_RETRY(dev);
+				dev->wait_us = BME280_STATUS_POLL_US;
+				dev->step = 2;
+				return 0;
+			}
+			_i2c->reg = BME280_REG_DATA;
+			_i2c->len = BME280_DATA_LEN;
+			_i2c->mode = I2C_MODE_READ;
+			dev->step = 4;
+			break;
+		case 4:
+			bme280_parse_forced_data(_i2c, dev);
+			if (dev->on_raw) {
+				dev->on_raw(dev->raw_ctx, &dev->uncomp_data);
+			}
+			dev->step = 0;
+			STATS_DONE(dev);
+			return 1;
+			break;
+		default:
+			dev->step = 0;
+			break;
+		}
+		start_transfer(_i2c, dev);
+	}
+	return 0;
+}
+
+/*!
+ *  @brief This API drops the operation in progress after a port error or a
+ *  timeout: the error is taken from the port (status back to PORT_FREE)
+ *  and dev->step starts over. Abort the transfer in the port driver first
+ *  on a timeout.
+ */
+void BME280_Abort(I2C_Connection *_i2c, BME280_t *dev) {
+	STATS_ABORT(_i2c, dev);
+	_i2c->status = PORT_FREE;
+	dev->step = 0;
+	dev->wait_us = 0;
+	dev->status = INIT;
+}
+
+/*!
+ *  @brief This API brings an initialized sensor back after BME280_Abort:
+ *  soft reset, wait BME280_STARTUP_US for the start-up (a wait step, see
+ *  dev->wait_us: the sensor does not answer before), wait for the NVM copy
+ *  (status im_update) and write dev->config again with the calibration in
+ *  memory. On a 3-wire SPI bus spi3w_en, cleared by the reset, is written
+ *  again before the status read. Returns 1 with dev->status OK when done.
+ */
+uint8_t BME280_Recover(I2C_Connection *_i2c, BME280_t *dev) {
+	uint8_t st;
+
+	STATS_PORT(_i2c, dev);
+	if (_i2c->status == PORT_FREE) {//send setup
+		_i2c->addr = dev->addr;
+		dev->wait_us = 0;
+		switch (dev->step) {
+		case 0://soft reset
+			dev->status = INIT;
+			_i2c->reg = BME280_REG_RESET;
+			_i2c->len = 1;
+			_i2c->mode = I2C_MODE_WRITE;
+			PutOne(&_i2c->buffer, BME280_RESET_COMMAND);
+			dev->step = 1;
+			break;
+		case 1://wait the start-up time
+			dev->wait_us = BME280_STARTUP_US;
+			dev->step = 2;
+			return 0;
+		case 2://3-wire SPI: the reset cleared spi3w_en, enable it before the first read
+			if (put_spi3w(_i2c, dev)) {
+				dev->step = 3;
+				break;
+			}
+			/* fall through */
+		case 3://read status
+			_i2c->reg = BME280_REG_STATUS;
+			_i2c->len = 1;
+			_i2c->mode = I2C_MODE_READ;
+			dev->step = 4;
+			break;
+		case 4://setup when the NVM copy is done
+			GetMulti(&_i2c->buffer, &st, 1);
+			if (st & BME280_STATUS_IM_UPDATE) {
+				STATS_RETRY(dev);
+				_i2c->reg = BME280_REG_STATUS;
+				_i2c->len = 1;
+				_i2c->mode = I2C_MODE_READ;
+			} else {
+				put_setup(_i2c, dev);
+				dev->step = 5;
+			}
+			break;
+		case 5:
+			dev->status = OK;
+			dev->step = 0;
+			STATS_DONE(dev);
+			return 1;
+			break;
+		default:
+			dev->step = 0;
+			break;
+		}
+		start_transfer(_i2c, dev);
+	}
+	return 0;
+}
+
+//CALIBRATION CACHE	==========================================================
+static uint8_t crc8(const uint8_t *dt, uint8_t len) {
+	uint8_t crc = 0xFF;
+	uint8_t i;
+
+	while (len--) {
+		crc ^= *dt++;
+		for (i = 0; i < 8; i++) {
+			crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+		}
+	}
+	return crc;
+}
+
+static inline void put_u16(uint8_t *dt, uint16_t val) {
+	dt[0] = (uint8_t)val;
+	dt[1] = (uint8_t)(val >> 8);
+}
+
+//calibration coefficients to blob bytes 1..33, little endian
+static void calib_to_blob(const bme280_calib_data *cd, uint8_t *blob) {
+	put_u16(&blob[1], cd->dig_t1);
+	put_u16(&blob[3], (uint16_t)cd->dig_t2);
+	put_u16(&blob[5], (uint16_t)cd->dig_t3);
+	put_u16(&blob[7], cd->dig_p1);
+	put_u16(&blob[9], (uint16_t)cd->dig_p2);
+	put_u16(&blob[11], (uint16_t)cd->dig_p3);
+	put_u16(&blob[13], (uint16_t)cd->dig_p4);
+	put_u16(&blob[15], (uint16_t)cd->dig_p5);
+	put_u16(&blob[17], (uint16_t)cd->dig_p6);
+	put_u16(&blob[19], (uint16_t)cd->dig_p7);
+	put_u16(&blob[21], (uint16_t)cd->dig_p8);
+	put_u16(&blob[23], (uint16_t)cd->dig_p9);
+	blob[25] = cd->dig_h1;
+	put_u16(&blob[26], (uint16_t)cd->dig_h2);
+	blob[28] = cd->dig_h3;
+	put_u16(&blob[29], (uint16_t)cd->dig_h4);
+	put_u16(&blob[31], (uint16_t)cd->dig_h5);
+	blob[33] = (uint8_t)cd->dig_h6;
+}
+
+/*!
+ *  @brief This API serializes the calibration data into a
+ *  BME280_CALIB_BLOB_LEN bytes blob: chip id, coefficients, CRC-8.
+ *  The application can keep it in flash for BME280_RestoreCalib.
+ */
+void BME280_SaveCalib(const BME280_t *dev, uint8_t *blob) {
+	blob[0] = BME280_CHIP_ID;
+	calib_to_blob(&dev->calib_data, blob);
+	blob[BME280_CALIB_BLOB_LEN - 1] = crc8(blob, BME280_CALIB_BLOB_LEN - 1);
+}
+
+/*!
+ *  @brief This API restores the calibration data from a blob made by
+ *  BME280_SaveCalib so BME280_Init skips the calibration reads.
+ *  Returns 0 and leaves dev unchanged if the chip id or CRC are wrong.
+ */
+uint8_t BME280_RestoreCalib(BME280_t *dev, const uint8_t *blob) {
+	bme280_calib_data *cd = &dev->calib_data;
+
+	if (blob[0] != BME280_CHIP_ID || crc8(blob, BME280_CALIB_BLOB_LEN - 1) != blob[BME280_CALIB_BLOB_LEN - 1]) {
+		return 0;
+	}
+	cd->dig_t1 = CONCAT_BYTES(blob[2], blob[1]);
+	cd->dig_t2 = (int16_t)CONCAT_BYTES(blob[4], blob[3]);
+	cd->dig_t3 = (int16_t)CONCAT_BYTES(blob[6], blob[5]);
+	cd->dig_p1 = CONCAT_BYTES(blob[8], blob[7]);
+	cd->dig_p2 = (int16_t)CONCAT_BYTES(blob[10], blob[9]);
+	cd->dig_p3 = (int16_t)CONCAT_BYTES(blob[12], blob[11]);
+	cd->dig_p4 = (int16_t)CONCAT_BYTES(blob[14], blob[13]);
+	cd->dig_p5 = (int16_t)CONCAT_BYTES(blob[16], blob[15]);
+	cd->dig_p6 = (int16_t)CONCAT_BYTES(blob[18], blob[17]);
+	cd->dig_p7 = (int16_t)CONCAT_BYTES(blob[20], blob[19]);
+	cd->dig_p8 = (int16_t)CONCAT_BYTES(blob[22], blob[21]);
+	cd->dig_p9 = (int16_t)CONCAT_BYTES(blob[24], blob[23]);
+	cd->dig_h1 = blob[25];
+	cd->dig_h2 = (int16_t)CONCAT_BYTES(blob[27], blob[26]);
+	cd->dig_h3 = blob[28];
+	cd->dig_h4 = (int16_t)CONCAT_BYTES(blob[30], blob[29]);
+	cd->dig_h5 = (int16_t)CONCAT_BYTES(blob[32], blob[31]);
+	cd->dig_h6 = (int8_t)blob[33];
+	bme280_prepare_calib_data(dev);
+	dev->calib_cached = 1;
+	return 1;
+}
+
+/*!
+ *  @brief This API reads the calibration again and compares it with the
+ *  one in use, e.g. in the background after a cached start. The chip id is
+ *  checked first and both blocks are decoded into a copy, dev is changed
+ *  only when both reads are done: on mismatch the sensor values are taken,
+ *  dev->calib_cached is cleared and dev->error is set to BME280_ERR_CALIB so
+ *  the application can save a new blob. On BME280_ERR_CHIP_ID the calibration
+ *  in use is kept. Returns 1 when the check is done.
+ */
+uint8_t BME280_VerifyCalib(I2C_Connection *_i2c, BME280_t *dev) {
+	uint8_t dt[BME280_ID_HUM_CALIB_DATA_LEN];
+	uint8_t old_blob[BME280_CALIB_BLOB_LEN];
+	uint8_t new_blob[BME280_CALIB_BLOB_LEN];
+	bme280_calib_data cd;
+
+	STATS_PORT(_i2c, dev);
+	if (_i2c->status == PORT_FREE) {//send setup
+		_i2c->addr = dev->addr;
+		dev->wait_us = 0;
+		switch (dev->step) {
+		case 0://read chip id and calib humidity data
+			dev->error = BME280_ERR_NONE;
+			_i2c->reg = BME280_REG_CHIP_ID;
+			_i2c->len = BME280_ID_HUM_CALIB_DATA_LEN;
+			_i2c->mode = I2C_MODE_READ;
+			dev->step = 1;
+			break;
+		case 1://check chip id, keep the humidity block, read calib temp pressure data
+			GetMulti(&_i2c->buffer, dt, BME280_ID_HUM_CALIB_DATA_LEN);
+			if (dt[0] != BME280_CHIP_ID) {
+				dev->error = BME280_ERR_CHIP_ID;
+				dev->step = 0;
+				STATS_DONE(dev);
+				return 1;
+			}
+			memcpy(dev->calib_hum, &dt[BME280_REG_HUM_CALIB_DATA - BME280_REG_CHIP_ID], BME280_HUM_CALIB_DATA_LEN);
+			_i2c->reg = BME280_REG_T_P_CALIB_DATA;
+			_i2c->len = BME280_T_P_CALIB_DATA_LEN;
+			_i2c->mode = I2C_MODE_READ;
+			dev->step = 2;
+			break;
+		case 2://decode both blocks into a copy, take it on mismatch
+			GetMulti(&_i2c->buffer, dt, BME280_T_P_CALIB_DATA_LEN);
+			cd = dev->calib_data;
+			bme280_decode_temp_press_calib(dt, &cd);
+			bme280_decode_humidity_calib(dev->calib_hum, &cd);
+			calib_to_blob(&dev->calib_data, old_blob);
+			calib_to_blob(&cd, new_blob);
+			if (memcmp(&old_blob[1], &new_blob[1], BME280_CALIB_BLOB_LEN - 2) != 0) {
+				dev->calib_data = cd;
+				bme280_prepare_calib_data(dev);
+				dev->calib_cached = 0;
+				dev->error = BME280_ERR_CALIB;
+			}
+			dev->step = 0;
+			STATS_DONE(dev);
+			return 1;
+			break;
+		default:
+			dev->step = 0;
+			break;
+		}
+		start_transfer(_i2c, dev);
+	}
+	return 0;
+}
+
+static uint32_t oversampling_count(uint8_t osrs) {
+	static const uint8_t count[6] = {0, 1, 2, 4, 8, 16};
+	return count[osrs > 5 ? 5 : osrs];
+}
+
+/*!
+ *  @brief This API returns the maximum measurement time in microseconds
+ *  (datasheet appendix B) for the given oversampling register values.
+ */
+uint32_t BME280_MeasureTimeMax(uint8_t osrs_t, uint8_t osrs_p, uint8_t osrs_h) {
+	uint32_t t = oversampling_count((osrs_t >> 5) & 0x07);
+	uint32_t p = oversampling_count((osrs_p >> 2) & 0x07);
+	uint32_t h = oversampling_count(osrs_h & 0x07);
+
+	return 1250 + 2300 * t + (p ? 2300 * p + 575 : 0) + (h ? 2300 * h + 575 : 0);
+}
+
+/*!
+ *  @brief This API returns the typical measurement time in microseconds
+ *  (datasheet section 9.1) for the given oversampling register values.
+ */
+uint32_t BME280_MeasureTimeTyp(uint8_t osrs_t, uint8_t osrs_p, uint8_t osrs_h) {
+	uint32_t t = oversampling_count((osrs_t >> 5) & 0x07);
+	uint32_t p = oversampling_count((osrs_p >> 2) & 0x07);
+	uint32_t h = oversampling_count(osrs_h & 0x07);
+
+	return 1000 + 2000 * t + (p ? 2000 * p + 500 : 0) + (h ? 2000 * h + 500 : 0);
+}
+
+/*!
+ *  @brief This API returns the standby time t_sb in microseconds.
+ */
+uint32_t BME280_StandbyTime(uint8_t standby) {
+	static const uint32_t time[8] = {500, 62500, 125000, 250000, 500000, 1000000, 10000, 20000};
+	return time[(standby >> 5) & 0x07];
+}
+
+/*!
+ *  @brief This API returns the output data rate in mHz for the settings.
+ *  In normal mode it is the measurement cycle rate, in forced mode the
+ *  highest rate the application can trigger measurements at.
+ */
+uint32_t BME280_OutputDataRate(const bme280_config *cfg) {
+	return 1000000000UL / BME280_CyclePeriod(cfg);
+}
+
+/*!
+ *  @brief This API returns the time between two new samples in microseconds:
+ *  measurement plus standby time in normal mode, the longest measurement
+ *  time otherwise. Reading the data registers faster returns duplicates.
+ */
+uint32_t BME280_CyclePeriod(const bme280_config *cfg) {
+	if (cfg->mode == BME280_NORMAL_MODE) {
+		return BME280_MeasureTimeTyp(cfg->osrs_t, cfg->osrs_p, cfg->osrs_h) + BME280_StandbyTime(cfg->standby);
+	}
+	return BME280_MeasureTimeMax(cfg->osrs_t, cfg->osrs_p, cfg->osrs_h);
+}
+
+/*!
+ *  @brief This API returns the estimated RMS pressure noise in mPa for the
+ *  settings: the datasheet noise for the pressure oversampling reduced by
+ *  the IIR filter factor sqrt(1 / (2 * coeff - 1)). 0 if pressure is skipped.
+ */
+uint32_t BME280_PressureNoise(const bme280_config *cfg) {
+	static const uint16_t noise[6] = {0, 3300, 2600, 2100, 1600, 1300};
+	static const uint16_t filter[5] = {1000, 577, 378, 258, 180};
+	uint8_t osrs = (cfg->osrs_p >> 2) & 0x07;
+	uint8_t coeff = (cfg->filter >> 2) & 0x07;
+
+	return (uint32_t)noise[osrs > 5 ? 5 : osrs] * filter[coeff > 4 ? 4 : coeff] / 1000;
+}
 //CALCULATING	==========================================================================
 /*!
- *  @brief This API is used to parse the pressure, temperature and
- *  humidity data and store it in the bme280_uncomp_data structure instance.
+ *  @brief This API is used to decode the pressure, temperature and
+ *  humidity data in place from the BME280_DATA_LEN bytes read at
+ *  BME280_REG_DATA, e.g. straight from a DMA receive buffer.
  */
-void bme280_parse_sensor_data(I2C_Connection *_i2c, BME280_t *dev) {
+void bme280_decode_sensor_data(const uint8_t *dt, bme280_uncomp_data *uncomp) {
     /* Variables to store the sensor data */
     uint32_t data_xlsb;
     uint32_t data_lsb;
     uint32_t data_msb;
-    uint8_t dt[BME280_DATA_LEN];
-    GetMulti(&_i2c->buffer, dt, BME280_DATA_LEN);
     /* Store the parsed register values for pressure data */
     data_msb = (uint32_t)dt[0] << 12;
     data_lsb = (uint32_t)dt[1] << 4;
     data_xlsb = (uint32_t)dt[2] >> 4;
-    dev->uncomp_data.pressure = data_msb | data_lsb | data_xlsb;
+    uncomp->pressure = data_msb | data_lsb | data_xlsb;
     /* Store the parsed register values for temperature data */
     data_msb = (uint32_t)dt[3] << 12;
     data_lsb = (uint32_t)dt[4] << 4;
     data_xlsb = (uint32_t)dt[5] >> 4;
-    dev->uncomp_data.temperature = data_msb | data_lsb | data_xlsb;
+    uncomp->temperature = data_msb | data_lsb | data_xlsb;
     /* Store the parsed register values for humidity data */
     data_msb = (uint32_t)dt[6] << 8;
     data_lsb = (uint32_t)dt[7];
-    dev->uncomp_data.humidity = data_msb | data_lsb;
+    uncomp->humidity = data_msb | data_lsb;
 }
 
 /*!
- *  @brief This internal API is used to parse the temperature and
- *  pressure calibration data and store it in device structure.
+ *  @brief This API is used to decode the temperature and pressure
+ *  calibration data from the BME280_T_P_CALIB_DATA_LEN bytes read at
+ *  BME280_REG_T_P_CALIB_DATA.
  */
-void parse_temp_press_calib_data(I2C_Connection *_i2c, BME280_t *dev) {
-    uint8_t dt[BME280_T_P_CALIB_DATA_LEN];
-    GetMulti(&_i2c->buffer, dt, BME280_T_P_CALIB_DATA_LEN);
-	dev->calib_data.dig_t1 = CONCAT_BYTES(dt[1], dt[0]);
-	dev->calib_data.dig_t2 = (int16_t)CONCAT_BYTES(dt[3], dt[2]);
-	dev->calib_data.dig_t3 = (int16_t)CONCAT_BYTES(dt[5], dt[4]);
-	dev->calib_data.dig_p1 = CONCAT_BYTES(dt[7], dt[6]);
-	dev->calib_data.dig_p2 = (int16_t)CONCAT_BYTES(dt[9], dt[8]);
-	dev->calib_data.dig_p3 = (int16_t)CONCAT_BYTES(dt[11], dt[10]);
-	dev->calib_data.dig_p4 = (int16_t)CONCAT_BYTES(dt[13], dt[12]);
-	dev->calib_data.dig_p5 = (int16_t)CONCAT_BYTES(dt[15], dt[14]);
-	dev->calib_data.dig_p6 = (int16_t)CONCAT_BYTES(dt[17], dt[16]);
-	dev->calib_data.dig_p7 = (int16_t)CONCAT_BYTES(dt[19], dt[18]);
-	dev->calib_data.dig_p8 = (int16_t)CONCAT_BYTES(dt[21], dt[20]);
-	dev->calib_data.dig_p9 = (int16_t)CONCAT_BYTES(dt[23], dt[22]);
-	dev->calib_data.dig_h1 = dt[25];
-}
-
-void parse_humidity_calib_data(I2C_Connection *_i2c, BME280_t *dev) {//need check
+void bme280_decode_temp_press_calib(const uint8_t *dt, bme280_calib_data *cd) {
+	cd->dig_t1 = CONCAT_BYTES(dt[1], dt[0]);
+	cd->dig_t2 = (int16_t)CONCAT_BYTES(dt[3], dt[2]);
+	cd->dig_t3 = (int16_t)CONCAT_BYTES(dt[5], dt[4]);
+	cd->dig_p1 = CONCAT_BYTES(dt[7], dt[6]);
+	cd->dig_p2 = (int16_t)CONCAT_BYTES(dt[9], dt[8]);
+	cd->dig_p3 = (int16_t)CONCAT_BYTES(dt[11], dt[10]);
+	cd->dig_p4 = (int16_t)CONCAT_BYTES(dt[13], dt[12]);
+	cd->dig_p5 = (int16_t)CONCAT_BYTES(dt[15], dt[14]);
+	cd->dig_p6 = (int16_t)CONCAT_BYTES(dt[17], dt[16]);
+	cd->dig_p7 = (int16_t)CONCAT_BYTES(dt[19], dt[18]);
+	cd->dig_p8 = (int16_t)CONCAT_BYTES(dt[21], dt[20]);
+	cd->dig_p9 = (int16_t)CONCAT_BYTES(dt[23], dt[22]);
+	cd->dig_h1 = dt[25];
+}
+
+/*!
+ *  @brief This API is used to decode the humidity calibration data from
+ *  the BME280_HUM_CALIB_DATA_LEN bytes read at BME280_REG_HUM_CALIB_DATA.
+ */
+void bme280_decode_humidity_calib(const uint8_t *dt, bme280_calib_data *cd) {
     int16_t dig_h4_lsb;
     int16_t dig_h4_msb;
     int16_t dig_h5_lsb;
     int16_t dig_h5_msb;
-    uint8_t dt[7];
-    GetMulti(&_i2c->buffer, dt, 7);
-    dev->calib_data.dig_h2 = (int16_t)CONCAT_BYTES(dt[1], dt[0]);
-    dev->calib_data.dig_h3 = dt[2];
+    cd->dig_h2 = (int16_t)CONCAT_BYTES(dt[1], dt[0]);
+    cd->dig_h3 = dt[2];
     dig_h4_msb = (int16_t)(int8_t)dt[3] * 16;
     dig_h4_lsb = (int16_t)(dt[4] & 0x0F);
-    dev->calib_data.dig_h4 = dig_h4_msb | dig_h4_lsb;
+    cd->dig_h4 = dig_h4_msb | dig_h4_lsb;
     dig_h5_msb = (int16_t)(int8_t)dt[5] * 16;
     dig_h5_lsb = (int16_t)(dt[4] >> 4);
-    dev->calib_data.dig_h5 = dig_h5_msb | dig_h5_lsb;
-    dev->calib_data.dig_h6 = (int8_t)dt[6];
+    cd->dig_h5 = dig_h5_msb | dig_h5_lsb;
+    cd->dig_h6 = (int8_t)dt[6];
 }
 
+//new raw sample: all compensated data becomes dirty
+static void take_sample(BME280_t *dev, const bme280_uncomp_data *raw) {
+    dev->uncomp_data = *raw;
+    dev->fresh = 1;
+    dev->fresh_samples++;
+    dev->dirty = BME280_DIRTY_ALL;
+}
 
 /*!
- * @brief This internal API is used to compensate the raw temperature data and
- * return the compensated temperature data in integer data type.
+ *  @brief This API is used to parse the pressure, temperature and
+ *  humidity data of a normal mode read from the port buffer and store it
+ *  in the bme280_uncomp_data structure instance. A new frame marks all
+ *  compensated data dirty, a frame equal to the previous one (read again
+ *  before the sensor cycle ended) only clears dev->fresh.
  */
-int32_t compensate_temperature_int(BME280_t *dev) {
+void bme280_parse_sensor_data(I2C_Connection *_i2c, BME280_t *dev) {
+    uint8_t dt[BME280_DATA_LEN];
+    bme280_uncomp_data raw;
+    GetMulti(&_i2c->buffer, dt, BME280_DATA_LEN);
+    bme280_decode_sensor_data(dt, &raw);
+    if (raw.pressure == dev->uncomp_data.pressure && raw.temperature == dev->uncomp_data.temperature
+    		&& raw.humidity == dev->uncomp_data.humidity) {
+    	dev->fresh = 0;
+    	dev->dup_samples++;
+    	return;
+    }
+    take_sample(dev, &raw);
+}
+
+/*!
+ *  @brief This API is used to parse the data of a forced mode measurement.
+ *  Every forced frame is a new measurement, even with the same values as
+ *  the previous one (stable conditions), so it is always fresh.
+ */
+void bme280_parse_forced_data(I2C_Connection *_i2c, BME280_t *dev) {
+    uint8_t dt[BME280_DATA_LEN];
+    bme280_uncomp_data raw;
+    GetMulti(&_i2c->buffer, dt, BME280_DATA_LEN);
+    bme280_decode_sensor_data(dt, &raw);
+    take_sample(dev, &raw);
+}
+
+/*!
+ *  @brief This internal API is used to parse the temperature and
+ *  pressure calibration data and store it in device structure.
+ */
+void parse_temp_press_calib_data(I2C_Connection *_i2c, BME280_t *dev) {
+    uint8_t dt[BME280_T_P_CALIB_DATA_LEN];
+    GetMulti(&_i2c->buffer, dt, BME280_T_P_CALIB_DATA_LEN);
+    bme280_decode_temp_press_calib(dt, &dev->calib_data);
+}
+
+void parse_humidity_calib_data(I2C_Connection *_i2c, BME280_t *dev) {
+    uint8_t dt[BME280_HUM_CALIB_DATA_LEN];
+    GetMulti(&_i2c->buffer, dt, BME280_HUM_CALIB_DATA_LEN);
+    bme280_decode_humidity_calib(dt, &dev->calib_data);
+}
+
+/*!
+ *  @brief This API is used to parse the BME280_ID_HUM_CALIB_DATA_LEN
+ *  block read at BME280_REG_CHIP_ID. The whole block is consumed, the
+ *  humidity calibration is stored only if the chip id matches.
+ *  Returns 1 if the chip id is BME280_CHIP_ID.
+ */
+uint8_t parse_id_humidity_calib_data(I2C_Connection *_i2c, BME280_t *dev) {
+    uint8_t dt[BME280_ID_HUM_CALIB_DATA_LEN];
+    GetMulti(&_i2c->buffer, dt, BME280_ID_HUM_CALIB_DATA_LEN);
+    if (dt[0] != BME280_CHIP_ID) {
+        return 0;
+    }
+    bme280_decode_humidity_calib(&dt[BME280_REG_HUM_CALIB_DATA - BME280_REG_CHIP_ID], &dev->calib_data);
+    return 1;
+}
+
+/*!
+ *  @brief This API is used to derive the calibration terms used by
+ *  the compensation functions. It must be called after the calibration
+ *  data is parsed or changed.
+ */
+void bme280_prepare_calib_data(BME280_t *dev) {
+	bme280_calib_data *cd = &dev->calib_data;
+	bme280_calib_prep *cp = &dev->calib_prep;
+
+	cp->p4 = (int32_t)cd->dig_p4 * 65536;
+	cp->h4 = (int32_t)cd->dig_h4 * 1048576;
+#ifndef BME280_NO_FLOAT
+	cp->fp1 = (bme280_real)cd->dig_p1;
+	cp->fp2 = (bme280_real)cd->dig_p2;
+	cp->fp3 = (bme280_real)cd->dig_p3 / 524288.0f;
+	cp->fp4 = (bme280_real)cd->dig_p4 * 65536.0f;
+	cp->fp5 = (bme280_real)cd->dig_p5 * 2.0f;
+	cp->fp6 = (bme280_real)cd->dig_p6 / 32768.0f;
+	cp->fp7 = (bme280_real)cd->dig_p7;
+	cp->fp8 = (bme280_real)cd->dig_p8 / 32768.0f;
+	cp->fp9 = (bme280_real)cd->dig_p9 / 2147483648.0f;
+	cp->fh1 = (bme280_real)cd->dig_h1 / 524288.0f;
+	cp->fh2 = (bme280_real)cd->dig_h2 / 65536.0f;
+	cp->fh3 = (double)cd->dig_h3 / 67108864.0;
+	cp->fh4 = (double)cd->dig_h4 * 64.0;
+	cp->fh5 = (double)cd->dig_h5 / 16384.0;
+	cp->fh6 = (double)cd->dig_h6 / 67108864.0;
+#endif
+}
+
+/*!
+ * @brief This internal API is used to calculate the fine resolution temperature
+ * t_fine shared by the temperature, pressure and humidity compensation.
+ */
+static inline int32_t calculate_t_fine(const bme280_calib_data *cd, uint32_t raw) {
 	int32_t var1;
 	int32_t var2;
+
+	var1 = (int32_t)((raw / 8) - ((int32_t)cd->dig_t1 * 2));
+	var1 = (var1 * ((int32_t)cd->dig_t2)) / 2048;
+	var2 = (int32_t)((raw / 16) - ((int32_t)cd->dig_t1));
+	var2 = (((var2 * var2) / 4096) * ((int32_t)cd->dig_t3)) / 16384;
+	return var1 + var2;
+}
+
+static inline int32_t temperature_int(int32_t t_fine) {
 	int32_t temperature;
 	int32_t temperature_min = -4000;
 	int32_t temperature_max = 8500;
 
-	var1 = (int32_t)((dev->uncomp_data.temperature / 8) - ((int32_t)dev->calib_data.dig_t1 * 2));
-	var1 = (var1 * ((int32_t)dev->calib_data.dig_t2)) / 2048;
-	var2 = (int32_t)((dev->uncomp_data.temperature / 16) - ((int32_t)dev->calib_data.dig_t1));
-	var2 = (((var2 * var2) / 4096) * ((int32_t)dev->calib_data.dig_t3)) / 16384;
-	dev->calib_data.t_fine = var1 + var2;
-	temperature = (dev->calib_data.t_fine * 5 + 128) / 256;
+	temperature = (t_fine * 5 + 128) / 256;
+	if (temperature < temperature_min) {
+		temperature = temperature_min;
+	}
+	else if (temperature > temperature_max) {
+		temperature = temperature_max;
+	}
+	return temperature;
+}
+
+#ifndef BME280_NO_FLOAT
+/*!
+ * @brief The float kernels compute in bme280_real, double with
+ * BME280_DOUBLE_PRECISION like the Bosch reference driver.
+ */
+static inline float temperature_float(int32_t t_fine) {
+	bme280_real temperature;
+	bme280_real temperature_min = -40;
+	bme280_real temperature_max = 85;
+
+	temperature = (bme280_real)t_fine / 5120.0f;
 	if (temperature < temperature_min) {
 		temperature = temperature_min;
 	}
@@ -190,35 +1007,29 @@ int32_t compensate_temperature_int(BME280_t *dev) {
 	}
 	return temperature;
 }
+#endif
+
+/*!
+ * @brief This internal API is used to compensate the raw temperature data and
+ * return the compensated temperature data in integer data type.
+ */
+int32_t compensate_temperature_int(BME280_t *dev) {
+	dev->calib_data.t_fine = calculate_t_fine(&dev->calib_data, dev->uncomp_data.temperature);
+	return temperature_int(dev->calib_data.t_fine);
+}
 
+#ifndef BME280_NO_FLOAT
 float compensate_temperature_float(BME280_t *dev) {
-	float var1;
-	float var2;
-	float temperature;
-	float temperature_min = -40;
-	float temperature_max = 85;
-
-  var1 = ((float)dev->uncomp_data.temperature) / 16384.0 - ((float)dev->calib_data.dig_t1) / 1024.0;
-  var1 = var1 * ((float)dev->calib_data.dig_t2);
-  var2 = (((float)dev->uncomp_data.temperature) / 131072.0 - ((float)dev->calib_data.dig_t1) / 8192.0);
-  var2 = (var2 * var2) * ((double)dev->calib_data.dig_t3);
-  dev->calib_data.t_fine = (int32_t)(var1 + var2);
-  temperature = (var1 + var2) / 5120.0;
-
-  if (temperature < temperature_min) {
-  	temperature = temperature_min;
-  }
-  else if (temperature > temperature_max) {
-    temperature = temperature_max;
-  }
-  return temperature;
+	dev->calib_data.t_fine = calculate_t_fine(&dev->calib_data, dev->uncomp_data.temperature);
+	return temperature_float(dev->calib_data.t_fine);
 }
+#endif
 
 /*!
  * @brief This internal API is used to compensate the raw pressure data and
  * return the compensated pressure data in integer data type.
  */
-uint32_t compensate_pressure_int(BME280_t *dev) {
+static inline uint32_t pressure_int(const bme280_calib_data *cd, const bme280_calib_prep *cp, int32_t t_fine, uint32_t raw) {
     int32_t var1;
     int32_t var2;
     int32_t var3;
@@ -228,17 +1039,17 @@ uint32_t compensate_pressure_int(BME280_t *dev) {
     uint32_t pressure_min = 30000;
     uint32_t pressure_max = 110000;
 
-    var1 = (((int32_t)dev->calib_data.t_fine) / 2) - (int32_t)64000;
-    var2 = (((var1 / 4) * (var1 / 4)) / 2048) * ((int32_t)dev->calib_data.dig_p6);
-    var2 = var2 + ((var1 * ((int32_t)dev->calib_data.dig_p5)) * 2);
-    var2 = (var2 / 4) + (((int32_t)dev->calib_data.dig_p4) * 65536);
-    var3 = (dev->calib_data.dig_p3 * (((var1 / 4) * (var1 / 4)) / 8192)) / 8;
-    var4 = (((int32_t)dev->calib_data.dig_p2) * var1) / 2;
+    var1 = (((int32_t)t_fine) / 2) - (int32_t)64000;
+    var2 = (((var1 / 4) * (var1 / 4)) / 2048) * ((int32_t)cd->dig_p6);
+    var2 = var2 + ((var1 * ((int32_t)cd->dig_p5)) * 2);
+    var2 = (var2 / 4) + cp->p4;
+    var3 = (cd->dig_p3 * (((var1 / 4) * (var1 / 4)) / 8192)) / 8;
+    var4 = (((int32_t)cd->dig_p2) * var1) / 2;
     var1 = (var3 + var4) / 262144;
-    var1 = (((32768 + var1)) * ((int32_t)dev->calib_data.dig_p1)) / 32768;
+    var1 = (((32768 + var1)) * ((int32_t)cd->dig_p1)) / 32768;
     /* avoid exception caused by division by zero */
     if (var1) {
-        var5 = (uint32_t)((uint32_t)1048576) - dev->uncomp_data.pressure;
+        var5 = (uint32_t)((uint32_t)1048576) - raw;
         pressure = ((uint32_t)(var5 - (uint32_t)(var2 / 4096))) * 3125;
         if (pressure < 0x80000000) {
             pressure = (pressure << 1) / ((uint32_t)var1);
@@ -246,9 +1057,9 @@ uint32_t compensate_pressure_int(BME280_t *dev) {
         else {
             pressure = (pressure / (uint32_t)var1) * 2;
         }
-        var1 = (((int32_t)dev->calib_data.dig_p9) * ((int32_t)(((pressure / 8) * (pressure / 8)) / 8192))) / 4096;
-        var2 = (((int32_t)(pressure / 4)) * ((int32_t)dev->calib_data.dig_p8)) / 8192;
-        pressure = (uint32_t)((int32_t)pressure + ((var1 + var2 + dev->calib_data.dig_p7) / 16));
+        var1 = (((int32_t)cd->dig_p9) * ((int32_t)(((pressure / 8) * (pressure / 8)) / 8192))) / 4096;
+        var2 = (((int32_t)(pressure / 4)) * ((int32_t)cd->dig_p8)) / 8192;
+        pressure = (uint32_t)((int32_t)pressure + ((var1 + var2 + cd->dig_p7) / 16));
         if (pressure < pressure_min) {
             pressure = pressure_min;
         }
@@ -262,29 +1073,77 @@ uint32_t compensate_pressure_int(BME280_t *dev) {
     return pressure;
 }
 
-float compensate_pressure_float(BME280_t *dev) {
-	float var1;
-	float var2;
-	float var3;
-	float pressure;
-	float pressure_min = 30000.0;
-	float pressure_max = 110000.0;
-
-  var1 = ((float)dev->calib_data.t_fine / 2.0) - 64000.0;
-  var2 = var1 * var1 * ((float)dev->calib_data.dig_p6) / 32768.0;
-  var2 = var2 + var1 * ((float)dev->calib_data.dig_p5) * 2.0;
-  var2 = (var2 / 4.0) + (((float)dev->calib_data.dig_p4) * 65536.0);
-  var3 = ((float)dev->calib_data.dig_p3) * var1 * var1 / 524288.0;
-  var1 = (var3 + ((float)dev->calib_data.dig_p2) * var1) / 524288.0;
-  var1 = (1.0 + var1 / 32768.0) * ((float)dev->calib_data.dig_p1);
+uint32_t compensate_pressure_int(BME280_t *dev) {
+	return pressure_int(&dev->calib_data, &dev->calib_prep, dev->calib_data.t_fine, dev->uncomp_data.pressure);
+}
+
+/*!
+ * @brief This internal API is used to compensate the raw pressure data with
+ * the 64 bit integer formula of the datasheet and return the pressure in
+ * Pa/256 (Q24.8), without float and more precise than pressure_int.
+ */
+static inline uint32_t pressure_int64(const bme280_calib_data *cd, const bme280_calib_prep *cp, int32_t t_fine, uint32_t raw) {
+    int64_t var1;
+    int64_t var2;
+    int64_t pressure;
+    int64_t pressure_min = 30000 * 256;
+    int64_t pressure_max = 110000 * 256;
+
+    var1 = ((int64_t)t_fine) - 128000;
+    var2 = var1 * var1 * (int64_t)cd->dig_p6;
+    var2 = var2 + ((var1 * (int64_t)cd->dig_p5) * 131072);
+    var2 = var2 + ((int64_t)cp->p4 * 524288);
+    var1 = ((var1 * var1 * (int64_t)cd->dig_p3) / 256) + ((var1 * (int64_t)cd->dig_p2) * 4096);
+    var1 = (((int64_t)1 * 140737488355328) + var1) * ((int64_t)cd->dig_p1) / 8589934592;
+    /* avoid exception caused by division by zero */
+    if (var1) {
+        pressure = 1048576 - (int64_t)raw;
+        pressure = (((pressure * 2147483648) - var2) * 3125) / var1;
+        var1 = (((int64_t)cd->dig_p9) * (pressure / 8192) * (pressure / 8192)) / 33554432;
+        var2 = (((int64_t)cd->dig_p8) * pressure) / 524288;
+        pressure = ((pressure + var1 + var2) / 256) + (((int64_t)cd->dig_p7) * 16);
+        if (pressure < pressure_min) {
+            pressure = pressure_min;
+        }
+        else if (pressure > pressure_max) {
+            pressure = pressure_max;
+        }
+    }
+    else {
+        pressure = pressure_min;
+    }
+    return (uint32_t)pressure;
+}
+
+uint32_t compensate_pressure_int64(BME280_t *dev) {
+	return pressure_int64(&dev->calib_data, &dev->calib_prep, dev->calib_data.t_fine, dev->uncomp_data.pressure);
+}
+
+#ifndef BME280_NO_FLOAT
+
+static inline float pressure_float(const bme280_calib_prep *cp, int32_t t_fine, uint32_t raw) {
+	bme280_real var1;
+	bme280_real var2;
+	bme280_real var3;
+	bme280_real pressure;
+	bme280_real pressure_min = 30000.0;
+	bme280_real pressure_max = 110000.0;
+
+  var1 = ((bme280_real)t_fine / 2.0) - 64000.0;
+  var2 = var1 * var1 * cp->fp6;
+  var2 = var2 + var1 * cp->fp5;
+  var2 = (var2 / 4.0) + cp->fp4;
+  var3 = cp->fp3 * var1 * var1;
+  var1 = (var3 + cp->fp2 * var1) / 524288.0;
+  var1 = (1.0 + var1 / 32768.0) * cp->fp1;
 
     /* avoid exception caused by division by zero */
   if (var1 > (0.0)) {
-  	pressure = 1048576.0 - (float) dev->uncomp_data.pressure;
+  	pressure = 1048576.0 - (bme280_real) raw;
   	pressure = (pressure - (var2 / 4096.0)) * 6250.0 / var1;
-  	var1 = ((float)dev->calib_data.dig_p9) * pressure * pressure / 2147483648.0;
-  	var2 = pressure * ((float)dev->calib_data.dig_p8) / 32768.0;
-  	pressure = pressure + (var1 + var2 + ((float)dev->calib_data.dig_p7)) / 16.0;
+  	var1 = cp->fp9 * pressure * pressure;
+  	var2 = pressure * cp->fp8;
+  	pressure = pressure + (var1 + var2 + cp->fp7) / 16.0;
   	if (pressure < pressure_min) {
   		pressure = pressure_min;
       	}
@@ -297,11 +1156,17 @@ float compensate_pressure_float(BME280_t *dev) {
   }
    return pressure;
 }
+
+float compensate_pressure_float(BME280_t *dev) {
+	return pressure_float(&dev->calib_prep, dev->calib_data.t_fine, dev->uncomp_data.pressure);
+}
+#endif
+
 /*!
  * @brief This internal API is used to compensate the raw humidity data and
  * return the compensated humidity data in integer data type.
  */
-uint32_t compensate_humidity_int(BME280_t *dev) {
+static inline uint32_t humidity_int(const bme280_calib_data *cd, const bme280_calib_prep *cp, int32_t t_fine, uint32_t raw) {
     int32_t var1;
     int32_t var2;
     int32_t var3;
@@ -310,18 +1175,18 @@ uint32_t compensate_humidity_int(BME280_t *dev) {
     uint32_t humidity;
     uint32_t humidity_max = 102400;
 
-    var1 = dev->calib_data.t_fine - ((int32_t)76800);
-    var2 = (int32_t)(dev->uncomp_data.humidity * 16384);
-    var3 = (int32_t)(((int32_t)dev->calib_data.dig_h4) * 1048576);
-    var4 = ((int32_t)dev->calib_data.dig_h5) * var1;
+    var1 = t_fine - ((int32_t)76800);
+    var2 = (int32_t)(raw * 16384);
+    var3 = cp->h4;
+    var4 = ((int32_t)cd->dig_h5) * var1;
     var5 = (((var2 - var3) - var4) + (int32_t)16384) / 32768;
-    var2 = (var1 * ((int32_t)dev->calib_data.dig_h6)) / 1024;
-    var3 = (var1 * ((int32_t)dev->calib_data.dig_h3)) / 2048;
+    var2 = (var1 * ((int32_t)cd->dig_h6)) / 1024;
+    var3 = (var1 * ((int32_t)cd->dig_h3)) / 2048;
     var4 = ((var2 * (var3 + (int32_t)32768)) / 1024) + (int32_t)2097152;
-    var2 = ((var4 * ((int32_t)dev->calib_data.dig_h2)) + 8192) / 16384;
+    var2 = ((var4 * ((int32_t)cd->dig_h2)) + 8192) / 16384;
     var3 = var5 * var2;
     var4 = ((var3 / 32768) * (var3 / 32768)) / 128;
-    var5 = var3 - ((var4 * ((int32_t)dev->calib_data.dig_h1)) / 16);
+    var5 = var3 - ((var4 * ((int32_t)cd->dig_h1)) / 16);
     var5 = (var5 < 0 ? 0 : var5);
     var5 = (var5 > 419430400 ? 419430400 : var5);
     humidity = (uint32_t)(var5 / 4096);
@@ -331,25 +1196,31 @@ uint32_t compensate_humidity_int(BME280_t *dev) {
     return humidity;
 }
 
-float compensate_humidity_float(BME280_t *dev) {
-	float humidity;
-	float humidity_min = 0.0;
-	float humidity_max = 100.0;
-	float var1;
-	float var2;
-	float var3;
-	float var4;
-	float var5;
-	float var6;
-
-  var1 = ((float)dev->calib_data.t_fine) - 76800.0;
-  var2 = (((float)dev->calib_data.dig_h4) * 64.0 + (((float)dev->calib_data.dig_h5) / 16384.0) * var1);
-  var3 = dev->uncomp_data.humidity - var2;
-  var4 = ((float)dev->calib_data.dig_h2) / 65536.0;
-  var5 = (1.0 + (((float)dev->calib_data.dig_h3) / 67108864.0) * var1);
-  var6 = 1.0 + (((float)dev->calib_data.dig_h6) / 67108864.0) * var1 * var5;
+uint32_t compensate_humidity_int(BME280_t *dev) {
+	return humidity_int(&dev->calib_data, &dev->calib_prep, dev->calib_data.t_fine, dev->uncomp_data.humidity);
+}
+
+#ifndef BME280_NO_FLOAT
+
+static inline float humidity_float(const bme280_calib_prep *cp, int32_t t_fine, uint32_t raw) {
+	bme280_real humidity;
+	bme280_real humidity_min = 0.0;
+	bme280_real humidity_max = 100.0;
+	bme280_real var1;
+	bme280_real var2;
+	bme280_real var3;
+	bme280_real var4;
+	bme280_real var5;
+	bme280_real var6;
+
+  var1 = ((bme280_real)t_fine) - 76800.0;
+  var2 = cp->fh4 + cp->fh5 * var1;
+  var3 = raw - var2;
+  var4 = cp->fh2;
+  var5 = 1.0 + cp->fh3 * var1;
+  var6 = 1.0 + cp->fh6 * var1 * var5;
   var6 = var3 * var4 * (var5 * var6);
-  humidity = var6 * (1.0 - ((float)dev->calib_data.dig_h1) * var6 / 524288.0);
+  humidity = var6 * (1.0 - cp->fh1 * var6);
   if (humidity > humidity_max) {
   	humidity = humidity_max;
   }
@@ -359,6 +1230,11 @@ float compensate_humidity_float(BME280_t *dev) {
   return humidity;
 }
 
+float compensate_humidity_float(BME280_t *dev) {
+	return humidity_float(&dev->calib_prep, dev->calib_data.t_fine, dev->uncomp_data.humidity);
+}
+#endif
+
 /*!
  * @brief This API is used to compensate the pressure and/or
  * temperature and/or humidity data according to the component selected
@@ -371,8 +1247,10 @@ void bme280_calculate_data_int(BME280_t *dev) {
 	dev->data_int.pressure = compensate_pressure_int(dev);
 		/* Compensate the humidity data */
 	dev->data_int.humidity = compensate_humidity_int(dev);
+	dev->dirty &= ~(BME280_DIRTY_T_FINE | BME280_DIRTY_INT);
 }
 
+#ifndef BME280_NO_FLOAT
 void bme280_calculate_data_float(BME280_t *dev) {
 	/* Compensate the temperature data */
 	dev->data_float.temperature = compensate_temperature_float(dev);
@@ -380,4 +1258,248 @@ void bme280_calculate_data_float(BME280_t *dev) {
 	dev->data_float.pressure = compensate_pressure_float(dev);
 		/* Compensate the humidity data */
 	dev->data_float.humidity = compensate_humidity_float(dev);
+	dev->dirty &= ~(BME280_DIRTY_T_FINE | BME280_DIRTY_FLOAT);
+}
+#endif
+
+/*!
+ * @brief This API is used to compensate the data selected by dev->output.
+ * t_fine is calculated once and shared by the integer and float data.
+ */
+void bme280_calculate_data(BME280_t *dev) {
+#ifdef BME280_STATS
+	uint32_t start = stats_now();
+#endif
+
+	if (dev->output == BME280_OUTPUT_RAW) {
+		return;
+	}
+	dev->calib_data.t_fine = calculate_t_fine(&dev->calib_data, dev->uncomp_data.temperature);
+	dev->dirty &= ~BME280_DIRTY_T_FINE;
+#ifdef BME280_NO_FLOAT
+	{
+#else
+	if (dev->output != BME280_OUTPUT_FLOAT) {
+#endif
+		dev->data_int.temperature = temperature_int(dev->calib_data.t_fine);
+		dev->data_int.pressure = compensate_pressure_int(dev);
+		dev->data_int.humidity = compensate_humidity_int(dev);
+		dev->dirty &= ~BME280_DIRTY_INT;
+	}
+#ifndef BME280_NO_FLOAT
+	if (dev->output != BME280_OUTPUT_INT) {
+		dev->data_float.temperature = temperature_float(dev->calib_data.t_fine);
+		dev->data_float.pressure = compensate_pressure_float(dev);
+		dev->data_float.humidity = compensate_humidity_float(dev);
+		dev->dirty &= ~BME280_DIRTY_FLOAT;
+	}
+#endif
+#ifdef BME280_STATS
+	stats_comp(dev, start);
+#endif
+}
+
+/*!
+ * @brief This internal API makes t_fine of the current raw sample valid
+ * and reports if the data flag is still dirty, clearing it.
+ */
+static uint8_t take_dirty(BME280_t *dev, uint8_t flag) {
+	if (dev->dirty & BME280_DIRTY_T_FINE) {
+		dev->calib_data.t_fine = calculate_t_fine(&dev->calib_data, dev->uncomp_data.temperature);
+		dev->dirty &= ~BME280_DIRTY_T_FINE;
+	}
+	if (dev->dirty & flag) {
+		dev->dirty &= ~flag;
+		return 1;
+	}
+	return 0;
+}
+
+/*!
+ * @brief These APIs return one compensated value of the latest sample.
+ * The value is compensated on the first call after a new sample only, with
+ * BME280_OUTPUT_RAW this moves all compensation out of BME280_GetData and
+ * skips the channels nobody reads.
+ */
+int32_t BME280_GetTemperatureInt(BME280_t *dev) {
+	if (take_dirty(dev, BME280_DIRTY_INT_T)) {
+		dev->data_int.temperature = temperature_int(dev->calib_data.t_fine);
+	}
+	return dev->data_int.temperature;
+}
+
+uint32_t BME280_GetPressureInt(BME280_t *dev) {
+	if (take_dirty(dev, BME280_DIRTY_INT_P)) {
+		dev->data_int.pressure = compensate_pressure_int(dev);
+	}
+	return dev->data_int.pressure;
+}
+
+uint32_t BME280_GetHumidityInt(BME280_t *dev) {
+	if (take_dirty(dev, BME280_DIRTY_INT_H)) {
+		dev->data_int.humidity = compensate_humidity_int(dev);
+	}
+	return dev->data_int.humidity;
+}
+
+/*!
+ * @brief This API returns the pressure of the latest sample in Pa/256 from
+ * the 64 bit integer compensation. It is computed on every call, not cached.
+ */
+uint32_t BME280_GetPressureInt64(BME280_t *dev) {
+	take_dirty(dev, 0);
+	return compensate_pressure_int64(dev);
+}
+
+#ifndef BME280_NO_FLOAT
+float BME280_GetTemperatureFloat(BME280_t *dev) {
+	if (take_dirty(dev, BME280_DIRTY_FLOAT_T)) {
+		dev->data_float.temperature = temperature_float(dev->calib_data.t_fine);
+	}
+	return dev->data_float.temperature;
+}
+
+float BME280_GetPressureFloat(BME280_t *dev) {
+	if (take_dirty(dev, BME280_DIRTY_FLOAT_P)) {
+		dev->data_float.pressure = compensate_pressure_float(dev);
+	}
+	return dev->data_float.pressure;
+}
+
+float BME280_GetHumidityFloat(BME280_t *dev) {
+	if (take_dirty(dev, BME280_DIRTY_FLOAT_H)) {
+		dev->data_float.humidity = compensate_humidity_float(dev);
+	}
+	return dev->data_float.humidity;
+}
+#endif
+
+/*!
+ * @brief This internal API compensates a block of samples sharing one
+ * calibration. The channels are handled in separate loops over the block
+ * of t_fine values so the compiler can vectorize the branch-free ones.
+ */
+static void batch_block_int(const bme280_calib_data *cd, const bme280_calib_prep *cp,
+		const uint32_t *raw_t, const uint32_t *raw_p, const uint32_t *raw_h,
+		int32_t *temperature, uint32_t *pressure, uint32_t *humidity, uint32_t cnt) {
+	int32_t t_fine[BME280_BATCH_BLOCK];
+	uint32_t i;
+
+	for (i = 0; i < cnt; i++) {
+		t_fine[i] = calculate_t_fine(cd, raw_t[i]);
+	}
+	if (temperature) {
+		for (i = 0; i < cnt; i++) {
+			temperature[i] = temperature_int(t_fine[i]);
+		}
+	}
+	if (pressure) {
+		for (i = 0; i < cnt; i++) {
+			pressure[i] = pressure_int(cd, cp, t_fine[i], raw_p[i]);
+		}
+	}
+	if (humidity) {
+		for (i = 0; i < cnt; i++) {
+			humidity[i] = humidity_int(cd, cp, t_fine[i], raw_h[i]);
+		}
+	}
+}
+
+#ifndef BME280_NO_FLOAT
+static void batch_block_float(const bme280_calib_data *cd, const bme280_calib_prep *cp,
+		const uint32_t *raw_t, const uint32_t *raw_p, const uint32_t *raw_h,
+		float *temperature, float *pressure, float *humidity, uint32_t cnt) {
+	int32_t t_fine[BME280_BATCH_BLOCK];
+	uint32_t i;
+
+	for (i = 0; i < cnt; i++) {
+		t_fine[i] = calculate_t_fine(cd, raw_t[i]);
+	}
+	if (temperature) {
+		for (i = 0; i < cnt; i++) {
+			temperature[i] = temperature_float(t_fine[i]);
+		}
+	}
+	if (pressure) {
+		for (i = 0; i < cnt; i++) {
+			pressure[i] = pressure_float(cp, t_fine[i], raw_p[i]);
+		}
+	}
+	if (humidity) {
+		for (i = 0; i < cnt; i++) {
+			humidity[i] = humidity_float(cp, t_fine[i], raw_h[i]);
+		}
+	}
+}
+#endif
+
+/*!
+ * @brief This API is used to compensate arrays of raw samples (structure of
+ * arrays layout). With per_sample_dev 0 all samples use the calibration of
+ * dev[0] (dev may point to a single sensor), else sample i uses the
+ * calibration of dev[i] and dev holds len sensors.
+ * Any output array may be NULL to skip that channel.
+ */
+void bme280_compensate_batch_int(const BME280_t *const *dev, uint8_t per_sample_dev,
+		const uint32_t *raw_temperature, const uint32_t *raw_pressure, const uint32_t *raw_humidity,
+		int32_t *temperature, uint32_t *pressure, uint32_t *humidity, uint32_t len) {
+	uint32_t base;
+	uint32_t cnt;
+	int32_t t_fine;
+
+	if (!per_sample_dev) {
+		for (base = 0; base < len; base += cnt) {
+			cnt = (len - base < BME280_BATCH_BLOCK) ? (len - base) : BME280_BATCH_BLOCK;
+			batch_block_int(&dev[0]->calib_data, &dev[0]->calib_prep,
+					raw_temperature + base, raw_pressure + base, raw_humidity + base,
+					temperature ? temperature + base : 0, pressure ? pressure + base : 0,
+					humidity ? humidity + base : 0, cnt);
+		}
+		return;
+	}
+	for (base = 0; base < len; base++) {
+		t_fine = calculate_t_fine(&dev[base]->calib_data, raw_temperature[base]);
+		if (temperature) {
+			temperature[base] = temperature_int(t_fine);
+		}
+		if (pressure) {
+			pressure[base] = pressure_int(&dev[base]->calib_data, &dev[base]->calib_prep, t_fine, raw_pressure[base]);
+		}
+		if (humidity) {
+			humidity[base] = humidity_int(&dev[base]->calib_data, &dev[base]->calib_prep, t_fine, raw_humidity[base]);
+		}
+	}
+}
+
+#ifndef BME280_NO_FLOAT
+void bme280_compensate_batch_float(const BME280_t *const *dev, uint8_t per_sample_dev,
+		const uint32_t *raw_temperature, const uint32_t *raw_pressure, const uint32_t *raw_humidity,
+		float *temperature, float *pressure, float *humidity, uint32_t len) {
+	uint32_t base;
+	uint32_t cnt;
+	int32_t t_fine;
+
+	if (!per_sample_dev) {
+		for (base = 0; base < len; base += cnt) {
+			cnt = (len - base < BME280_BATCH_BLOCK) ? (len - base) : BME280_BATCH_BLOCK;
+			batch_block_float(&dev[0]->calib_data, &dev[0]->calib_prep,
+					raw_temperature + base, raw_pressure + base, raw_humidity + base,
+					temperature ? temperature + base : 0, pressure ? pressure + base : 0,
+					humidity ? humidity + base : 0, cnt);
+		}
+		return;
+	}
+	for (base = 0; base < len; base++) {
+		t_fine = calculate_t_fine(&dev[base]->calib_data, raw_temperature[base]);
+		if (temperature) {
+			temperature[base] = temperature_float(t_fine);
+		}
+		if (pressure) {
+			pressure[base] = pressure_float(&dev[base]->calib_prep, t_fine, raw_pressure[base]);
+		}
+		if (humidity) {
+			humidity[base] = humidity_float(&dev[base]->calib_prep, t_fine, raw_humidity[base]);
+		}
+	}
 }
+#endif
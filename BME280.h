@@ -23,14 +23,96 @@
 extern "C" {
 #endif
 
+/* BME280_PORT_HEADER replaces the STM32 project headers, e.g. for a host build
+ * with a simulated port. It must provide I2C_Connection, Device_status_t,
+ * PutOne, PutMulti, GetMulti and I2C_Start_IRQ. */
+#ifdef BME280_PORT_HEADER
+#include BME280_PORT_HEADER
+#else
 #include "main.h"
 #include "I2C/MyI2C.h"
+#endif
 #include "BME280_Registers.h"
 //===========================================================================================
+#define BME280_BATCH_BLOCK	64	//samples compensated per block by the batch API
+#define BME280_CALIB_BLOB_LEN	35	//chip id, calibration coefficients, CRC-8
+#define BME280_STATUS_POLL_US	500	//status poll period of a conversion still running after dev->wait_us
+#define BME280_STARTUP_US		2000	//power on or soft reset to the first transfer, datasheet t_startup
+
+/* BME280_NO_FLOAT builds the integer-only profile: the float compensation,
+ * the float data and the float API are left out, so no soft-float code is
+ * linked. BME280_OUTPUT_FLOAT and BME280_OUTPUT_BOTH then give integer data. */
+#ifndef BME280_NO_FLOAT
+/* BME280_DOUBLE_PRECISION computes the float compensation in double like the
+ * Bosch reference driver, for host tools and MCUs with a double FPU.
+ * The data is still returned as float. */
+#ifdef BME280_DOUBLE_PRECISION
+typedef double bme280_real;
+#else
+typedef float bme280_real;
+#endif
+#endif
+
+enum BME280_BUS {
+	BME280_BUS_I2C	= 0x00,
+	BME280_BUS_SPI4	= 0x01,	//4-wire SPI
+	BME280_BUS_SPI3	= 0x02	//3-wire SPI, sets spi3w_en in the config register
+};
+#define BME280_SPI_READ	0x80	//SPI control byte bit 7: set to read, cleared to write
+
 enum BME280_ADDRESS {
 	BME280_ADDR1 = 0xEC,	//address 1 chip 0x76
 	BME280_ADDR2 = 0xED		//address 2 chip 0x77
 };
+//compensated output computed by BME280_GetData
+enum BME280_OUTPUT {
+	BME280_OUTPUT_BOTH	= 0x00,	//integer and float data (default)
+	BME280_OUTPUT_INT	= 0x01,	//integer data only
+	BME280_OUTPUT_FLOAT	= 0x02,	//float data only
+	BME280_OUTPUT_RAW	= 0x03	//uncompensated data only, compensate on demand with the getters
+};
+//dev->dirty flags: set by a new raw sample, cleared when the value is compensated
+enum BME280_DIRTY {
+	BME280_DIRTY_T_FINE		= 0x01,
+	BME280_DIRTY_INT_T		= 0x02,
+	BME280_DIRTY_INT_P		= 0x04,
+	BME280_DIRTY_INT_H		= 0x08,
+	BME280_DIRTY_FLOAT_T	= 0x10,
+	BME280_DIRTY_FLOAT_P	= 0x20,
+	BME280_DIRTY_FLOAT_H	= 0x40,
+	BME280_DIRTY_INT		= 0x0E,
+	BME280_DIRTY_FLOAT		= 0x70,
+	BME280_DIRTY_ALL		= 0x7F
+};
+//driver error codes
+enum BME280_ERROR {
+	BME280_ERR_NONE		= 0x00,
+	BME280_ERR_CHIP_ID	= 0x01,	//chip id is not BME280_CHIP_ID
+	BME280_ERR_CALIB	= 0x02,	//sensor calibration differs from the cached one
+	BME280_ERR_BUS		= 0x03,	//transfer ended with PORT_ERROR
+	BME280_ERR_CONFIG	= 0x04	//setup does not fit the bus (BME280.hpp), async wait without a timer
+};
+//recommended settings from the datasheet section 3.5
+enum BME280_PROFILE {
+	BME280_PROFILE_DEFAULT		= 0x00,	//normal mode, 16x oversampling, filter 16, standby 20 ms
+	BME280_PROFILE_WEATHER		= 0x01,	//forced mode, 1x oversampling, filter off
+	BME280_PROFILE_HUMIDITY		= 0x02,	//forced mode, pressure off, 1x oversampling, filter off
+	BME280_PROFILE_INDOOR_NAV	= 0x03,	//normal mode, t 2x p 16x h 1x, filter 16, standby 0.5 ms
+	BME280_PROFILE_GAMING		= 0x04	//normal mode, t 1x p 4x h off, filter 16, standby 0.5 ms
+};
+/*!
+ * @brief Measurement settings, fields hold the masks from BME280_Registers.h.
+ * A zero (sleep mode) config is replaced by BME280_PROFILE_DEFAULT at init.
+ */
+typedef struct bme280_config_t {
+		uint8_t mode;		// BME280_MODE
+		uint8_t osrs_t;		// BME280_TEMP_OVERSAMPLING
+		uint8_t osrs_p;		// BME280_PRESS_OVERSAMPLING
+		uint8_t osrs_h;		// BME280_HUM_OVERSAMPLING
+		uint8_t filter;		// BME280_FILTER_COEFF
+		uint8_t standby;	// BME280_STANDBY_TIME
+} bme280_config;
+
 /*!
  * @brief Calibration data
  */
@@ -56,6 +138,33 @@ typedef struct bme280_calib_data_t {
 		int32_t t_fine;		// Variable to store the intermediate temperature coefficient
 } bme280_calib_data;
 
+/*!
+ * @brief Calibration terms derived once from bme280_calib_data.
+ * Scale factors are powers of two folded into the coefficients, so the
+ * compensation results stay bit exact.
+ */
+typedef struct bme280_calib_prep_t {
+		int32_t p4;		// dig_p4 * 65536
+		int32_t h4;		// dig_h4 * 1048576
+#ifndef BME280_NO_FLOAT
+		bme280_real fp1;		// dig_p1
+		bme280_real fp2;		// dig_p2
+		bme280_real fp3;		// dig_p3 / 524288
+		bme280_real fp4;		// dig_p4 * 65536
+		bme280_real fp5;		// dig_p5 * 2
+		bme280_real fp6;		// dig_p6 / 32768
+		bme280_real fp7;		// dig_p7
+		bme280_real fp8;		// dig_p8 / 32768
+		bme280_real fp9;		// dig_p9 / 2147483648
+		bme280_real fh1;		// dig_h1 / 524288
+		bme280_real fh2;		// dig_h2 / 65536
+		double fh3;		// dig_h3 / 67108864
+		double fh4;		// dig_h4 * 64
+		double fh5;		// dig_h5 / 16384
+		double fh6;		// dig_h6 / 67108864
+#endif
+} bme280_calib_prep;
+
 /*!
  * @brief bme280 sensor structure which comprises of uncompensated temperature,
  * pressure and humidity data
@@ -72,6 +181,7 @@ typedef struct bme280_data_int_t {
 		uint32_t humidity;		// Compensated humidity
 } bme280_data_int;
 
+#ifndef BME280_NO_FLOAT
 /*!
  * @brief bme280 sensor structure which comprises of temperature, pressure and
  * humidity data
@@ -81,34 +191,139 @@ typedef struct bme280_data_float_t {
 		float temperature;	// Compensated temperature
 		float humidity;			// Compensated humidity
 } bme280_data_float;
+#endif
+
+/*!
+ * @brief Bus backend of a sensor. start begins the transfer prepared in the
+ * port (reg, len, mode and buffer) and reports the end in the port status
+ * the same way I2C_Start_IRQ does, so SPI drivers reuse I2C_Connection as
+ * the transfer descriptor. The driver sets bit 7 of reg for SPI.
+ */
+typedef struct bme280_transport_t {
+		uint8_t type;			// BME280_BUS
+		void (*start)(void *ctx, I2C_Connection *port);
+		void *ctx;				// SPI handle, chip select etc. of the application
+} bme280_transport;
+
+extern const bme280_transport bme280_i2c_transport;
+
+#ifdef BME280_STATS
+/*!
+ * @brief Bus and compensation counters of a sensor, times are in the units
+ * of the clock set by BME280_StatsClock (e.g. a cycle counter) and 0 without.
+ */
+typedef struct bme280_stats_t {
+		uint32_t transactions;	// Transfers started
+		uint32_t bytes;			// Data bytes of the transfers
+		uint32_t errors;		// Transfers ended with PORT_ERROR (NACK, bus error) or aborted
+		uint32_t retries;		// Repeated status polls: NVM copy or conversion running
+		uint32_t ops;			// Completed operations (BME280_Init, BME280_GetData...)
+		uint32_t lat_min;		// Operation time from the first request to completion
+		uint32_t lat_max;
+		uint64_t lat_sum;		// Average is lat_sum / ops
+		uint32_t comp_count;	// Compensations by bme280_calculate_data
+		uint32_t comp_max;		// Compensation time
+		uint64_t comp_sum;
+		uint32_t op_start;		// Internal: start of the current operation
+		uint8_t pending;		// Internal: transfer started, result not seen yet
+		uint8_t busy;			// Internal: operation running
+} bme280_stats;
+#endif
 
 //common data struct for sensor
 typedef struct bme280_dev_t {
 		const uint8_t addr;
 		uint8_t step;
+		uint32_t wait_us;	// Set by a step that started no transfer: call again after this time, cleared by the next step
 		Device_status_t status;
+		uint8_t error;		// Last error, see BME280_ERROR
+		uint8_t output;		// Compensated output selection, see BME280_OUTPUT
+		bme280_config config;
+		const uint8_t *setup_regs;	// Optional ctrl_hum, ctrl_meas, config bytes written instead of config, e.g. the constants of BME280.hpp
 		bme280_calib_data calib_data;
+		bme280_calib_prep calib_prep;
+		uint8_t calib_cached;	// Calibration restored from a blob, not read at init
+		uint8_t calib_hum[BME280_HUM_CALIB_DATA_LEN];	// Internal: humidity calibration block read by BME280_VerifyCalib
 		bme280_uncomp_data uncomp_data;
+		uint8_t dirty;		// Values not compensated for uncomp_data yet, see BME280_DIRTY
+		uint8_t fresh;		// Last read returned a new frame, 0 for a normal mode duplicate
+		uint32_t fresh_samples;	// New frames read
+		uint32_t dup_samples;	// Duplicate frames read
 		bme280_data_int data_int;
+#ifndef BME280_NO_FLOAT
 		bme280_data_float data_float;
+#endif
+		void (*on_raw)(void *ctx, const bme280_uncomp_data *raw);	// Optional, called with every new raw sample, e.g. BME280_LogAttach
+		void *raw_ctx;
+		const bme280_transport *bus;	// NULL for I2C with I2C_Start_IRQ
+#ifdef BME280_STATS
+		bme280_stats stats;
+#endif
 } BME280_t;
 
 //INITIALIZATION	================================================================
 uint8_t BME280_Init(I2C_Connection *_i2c, BME280_t *dev);
 uint8_t BME280_GetData(I2C_Connection *_i2c, BME280_t *dev);
+uint8_t BME280_GetDataForced(I2C_Connection *_i2c, BME280_t *dev);
+uint8_t BME280_ReadData(I2C_Connection *_i2c, BME280_t *dev);
+uint8_t BME280_ReadDataForced(I2C_Connection *_i2c, BME280_t *dev);
+void BME280_Abort(I2C_Connection *_i2c, BME280_t *dev);
+uint8_t BME280_Recover(I2C_Connection *_i2c, BME280_t *dev);
+void BME280_SetProfile(BME280_t *dev, uint8_t profile);
+uint8_t BME280_Configure(I2C_Connection *_i2c, BME280_t *dev);
+void BME280_SaveCalib(const BME280_t *dev, uint8_t *blob);
+uint8_t BME280_RestoreCalib(BME280_t *dev, const uint8_t *blob);
+uint8_t BME280_VerifyCalib(I2C_Connection *_i2c, BME280_t *dev);
+uint32_t BME280_MeasureTimeMax(uint8_t osrs_t, uint8_t osrs_p, uint8_t osrs_h);
+uint32_t BME280_MeasureTimeTyp(uint8_t osrs_t, uint8_t osrs_p, uint8_t osrs_h);
+uint32_t BME280_StandbyTime(uint8_t standby);
+uint32_t BME280_OutputDataRate(const bme280_config *cfg);
+uint32_t BME280_CyclePeriod(const bme280_config *cfg);
+uint32_t BME280_PressureNoise(const bme280_config *cfg);
+#ifdef BME280_STATS
+void BME280_StatsClock(uint32_t (*clock)(void));
+void BME280_StatsSnapshot(const BME280_t *dev, bme280_stats *out);
+void BME280_StatsReset(BME280_t *dev);
+#endif
 //CALCULATING	==========================================================================
 void parse_temp_press_calib_data(I2C_Connection *_i2c, BME280_t *dev);
 void parse_humidity_calib_data(I2C_Connection *_i2c, BME280_t *dev);
+uint8_t parse_id_humidity_calib_data(I2C_Connection *_i2c, BME280_t *dev);
+void bme280_prepare_calib_data(BME280_t *dev);
 void bme280_parse_sensor_data(I2C_Connection *_i2c, BME280_t *dev);
+void bme280_parse_forced_data(I2C_Connection *_i2c, BME280_t *dev);
+void bme280_decode_sensor_data(const uint8_t *dt, bme280_uncomp_data *uncomp);
+void bme280_decode_temp_press_calib(const uint8_t *dt, bme280_calib_data *cd);
+void bme280_decode_humidity_calib(const uint8_t *dt, bme280_calib_data *cd);
 int32_t compensate_temperature_int(BME280_t *dev);
-float compensate_temperature_float(BME280_t *dev);
 uint32_t compensate_pressure_int(BME280_t *dev);
-float compensate_pressure_float(BME280_t *dev);
+uint32_t compensate_pressure_int64(BME280_t *dev);
 uint32_t compensate_humidity_int(BME280_t *dev);
-float compensate_humidity_float(BME280_t *dev);
 
 void bme280_calculate_data_int(BME280_t *dev);
+void bme280_calculate_data(BME280_t *dev);
+int32_t BME280_GetTemperatureInt(BME280_t *dev);
+uint32_t BME280_GetPressureInt(BME280_t *dev);
+uint32_t BME280_GetPressureInt64(BME280_t *dev);
+uint32_t BME280_GetHumidityInt(BME280_t *dev);
+#ifndef BME280_NO_FLOAT
+float compensate_temperature_float(BME280_t *dev);
+float compensate_pressure_float(BME280_t *dev);
+float compensate_humidity_float(BME280_t *dev);
 void bme280_calculate_data_float(BME280_t *dev);
+float BME280_GetTemperatureFloat(BME280_t *dev);
+float BME280_GetPressureFloat(BME280_t *dev);
+float BME280_GetHumidityFloat(BME280_t *dev);
+#endif
+
+void bme280_compensate_batch_int(const BME280_t *const *dev, uint8_t per_sample_dev,
+		const uint32_t *raw_temperature, const uint32_t *raw_pressure, const uint32_t *raw_humidity,
+		int32_t *temperature, uint32_t *pressure, uint32_t *humidity, uint32_t len);
+#ifndef BME280_NO_FLOAT
+void bme280_compensate_batch_float(const BME280_t *const *dev, uint8_t per_sample_dev,
+		const uint32_t *raw_temperature, const uint32_t *raw_pressure, const uint32_t *raw_humidity,
+		float *temperature, float *pressure, float *humidity, uint32_t len);
+#endif
 
 #ifdef __cplusplus
 }
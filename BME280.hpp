@@ -0,0 +1,192 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	BME280.hpp
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+#ifndef BME280_BME280_HPP_
+#define BME280_BME280_HPP_
+
+#include "BME280.h"
+//===========================================================================================
+namespace bme280 {
+
+namespace detail {
+//samples per conversion for an oversampling field value
+constexpr uint32_t count(uint8_t osrs) {
+	return (osrs & 0x07) == 0 ? 0 : ((osrs & 0x07) >= 5 ? 16 : (1u << ((osrs & 0x07) - 1)));
+}
+
+//t_sb in microseconds for the config register value
+constexpr uint32_t standby_time(uint8_t standby) {
+	constexpr uint32_t time[8] = {500, 62500, 125000, 250000, 500000, 1000000, 10000, 20000};
+	return time[(standby >> 5) & 0x07];
+}
+} // namespace detail
+
+/*!
+ * @brief Sensor with its settings fixed at compile time, C++17.
+ * Register bytes and conversion times are constants, the setup writes these
+ * bytes. Samples are read by BME280_ReadData/BME280_ReadDataForced (stats,
+ * forced mode wait) that do not compensate, then only the channels measured
+ * in the output type selected are compensated by the getters, so with
+ * -ffunction-sections and --gc-sections the compensation of the other
+ * channels and bme280_calculate_data are not linked. The C API keeps working
+ * on dev() for everything else (calibration cache, log, metrics).
+ * Mode is BME280_NORMAL_MODE or BME280_FORCED_MODE, Output one of
+ * BME280_OUTPUT_BOTH, BME280_OUTPUT_INT or BME280_OUTPUT_FLOAT, Bus the
+ * BME280_BUS type of dev().bus.
+ */
+template <uint8_t Addr, uint8_t OsrsT, uint8_t OsrsP, uint8_t OsrsH,
+		uint8_t Filter = BME280_FILTER_COEFF_OFF, uint8_t Mode = BME280_NORMAL_MODE,
+		uint8_t Standby = BME280_STANDBY_TIME_0_5_MS, uint8_t Output = BME280_OUTPUT_INT,
+		uint8_t Bus = BME280_BUS_I2C>
+class Sensor {
+public:
+	static_assert(Addr == BME280_ADDR1 || Addr == BME280_ADDR2, "BME280 address is 0x76 or 0x77");
+	static_assert(OsrsT != BME280_TEMP_OVERSAMPLING_OFF, "temperature is needed by all channels");
+	static_assert(Mode == BME280_NORMAL_MODE || Mode == BME280_FORCED_MODE, "mode is normal or forced");
+	static_assert(Output == BME280_OUTPUT_BOTH || Output == BME280_OUTPUT_INT || Output == BME280_OUTPUT_FLOAT,
+			"output is int, float or both");
+	static_assert(Bus == BME280_BUS_I2C || Bus == BME280_BUS_SPI4 || Bus == BME280_BUS_SPI3, "bus is a BME280_BUS type");
+#ifdef BME280_NO_FLOAT
+	static_assert(Output == BME280_OUTPUT_INT, "BME280_NO_FLOAT builds have integer output only");
+#endif
+
+	static constexpr bool has_pressure = (OsrsP != BME280_PRESS_OVERSAMPLING_OFF);
+	static constexpr bool has_humidity = (OsrsH != BME280_HUM_OVERSAMPLING_OFF);
+	static constexpr bool has_int = (Output != BME280_OUTPUT_FLOAT);
+	static constexpr bool has_float = (Output != BME280_OUTPUT_INT);
+
+	//register values of the setup
+	static constexpr uint8_t ctrl_hum = OsrsH;
+	static constexpr uint8_t ctrl_meas = OsrsT | OsrsP | (Mode == BME280_NORMAL_MODE ? BME280_NORMAL_MODE : BME280_SLEEP_MODE);
+	static constexpr uint8_t config = Filter | Standby | (Bus == BME280_BUS_SPI3 ? BME280_SPI_3WIRE_MODE_ON : BME280_SPI_3WIRE_MODE_OFF);
+	static constexpr uint8_t setup_regs[3] = {ctrl_hum, ctrl_meas, config};
+	static constexpr bme280_config setup = {Mode, OsrsT, OsrsP, OsrsH, Filter, Standby};
+
+	//times in microseconds, datasheet section 9.1, same as BME280_MeasureTimeMax/Typ
+	static constexpr uint32_t measure_time_max = 1250 + 2300 * detail::count(OsrsT >> 5)
+			+ (has_pressure ? 2300 * detail::count(OsrsP >> 2) + 575 : 0) + (has_humidity ? 2300 * detail::count(OsrsH) + 575 : 0);
+	static constexpr uint32_t measure_time_typ = 1000 + 2000 * detail::count(OsrsT >> 5)
+			+ (has_pressure ? 2000 * detail::count(OsrsP >> 2) + 500 : 0) + (has_humidity ? 2000 * detail::count(OsrsH) + 500 : 0);
+	static constexpr uint32_t cycle_period = (Mode == BME280_NORMAL_MODE) ? measure_time_typ + detail::standby_time(Standby) : measure_time_max;
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#endif
+	//addr is const, the other members are zeroed by the aggregate initialization
+	Sensor() : dev_{Addr} {
+		dev_.config = setup;
+		dev_.setup_regs = setup_regs;
+		dev_.output = BME280_OUTPUT_RAW;
+	}
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+	BME280_t &dev() { return dev_; }
+	const BME280_t &dev() const { return dev_; }
+
+	/*!
+	 * @brief BME280_Init with the constant setup. Ends at once with
+	 * BME280_ERR_CONFIG if dev().bus is not of the type Bus.
+	 */
+	uint8_t Init(I2C_Connection *port) {
+		if ((dev_.bus ? dev_.bus->type : (uint8_t)BME280_BUS_I2C) != Bus) {
+			dev_.error = BME280_ERR_CONFIG;
+			return 1;
+		}
+		return BME280_Init(port, &dev_);
+	}
+
+	/*!
+	 * @brief Non-blocking read of one sample, call until it returns 1 like
+	 * BME280_ReadData or BME280_ReadDataForced, honouring dev().wait_us.
+	 * A duplicate frame clears dev().fresh and is not compensated.
+	 */
+	uint8_t GetData(I2C_Connection *port) {
+		uint8_t done;
+
+		if constexpr (Mode == BME280_FORCED_MODE) {
+			done = BME280_ReadDataForced(port, &dev_);
+		} else {
+			done = BME280_ReadData(port, &dev_);
+		}
+		if (done && dev_.fresh) {
+			compensate();
+		}
+		return done;
+	}
+
+	int32_t temperature() const { static_assert(has_int, "no integer output"); return dev_.data_int.temperature; }
+	uint32_t pressure() const {
+		static_assert(has_int, "no integer output");
+		static_assert(has_pressure, "pressure is off");
+		return dev_.data_int.pressure;
+	}
+	uint32_t humidity() const {
+		static_assert(has_int, "no integer output");
+		static_assert(has_humidity, "humidity is off");
+		return dev_.data_int.humidity;
+	}
+
+#ifndef BME280_NO_FLOAT
+	float temperature_float() const { static_assert(has_float, "no float output"); return dev_.data_float.temperature; }
+	float pressure_float() const {
+		static_assert(has_float, "no float output");
+		static_assert(has_pressure, "pressure is off");
+		return dev_.data_float.pressure;
+	}
+	float humidity_float() const {
+		static_assert(has_float, "no float output");
+		static_assert(has_humidity, "humidity is off");
+		return dev_.data_float.humidity;
+	}
+#endif
+
+private:
+	BME280_t dev_;
+
+	//the getters share one t_fine per sample, nothing else is compensated
+	void compensate() {
+		if constexpr (has_int) {
+			BME280_GetTemperatureInt(&dev_);
+			if constexpr (has_pressure) {
+				BME280_GetPressureInt(&dev_);
+			}
+			if constexpr (has_humidity) {
+				BME280_GetHumidityInt(&dev_);
+			}
+		}
+#ifndef BME280_NO_FLOAT
+		if constexpr (has_float) {
+			BME280_GetTemperatureFloat(&dev_);
+			if constexpr (has_pressure) {
+				BME280_GetPressureFloat(&dev_);
+			}
+			if constexpr (has_humidity) {
+				BME280_GetHumidityFloat(&dev_);
+			}
+		}
+#endif
+	}
+};
+
+} // namespace bme280
+
+#endif /* BME280_BME280_HPP_ */
@@ -0,0 +1,147 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	BME280_Async.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+#include "BME280_Async.h"
+
+static void finish(bme280_async *as) {
+	as->op = 0;
+	if (as->done) {
+		as->done(as->dev, as->ctx);
+	}
+}
+
+/* Runs steps until one starts a transfer or a wait, or the operation ends.
+ * An interrupt that comes while this runs (a transfer or timer completing
+ * inside its start call, or preempting BME280_AsyncStart) only sets
+ * as->kick and the loop goes on, so op is not entered twice. */
+static void advance(bme280_async *as) {
+	uint8_t (*op)(I2C_Connection *_i2c, BME280_t *dev) = as->op;
+
+	as->running = 1;
+	for (;;) {
+		as->kick = 0;
+		if (as->port->status == PORT_ERROR) {
+			BME280_Abort(as->port, as->dev);
+			as->dev->error = BME280_ERR_BUS;
+			break;
+		}
+		if (op(as->port, as->dev)) {
+			break;
+		}
+		if (as->port->status == PORT_FREE && as->dev->wait_us) {
+			if (!as->start_timer) {//the sensor state is fine, only this operation is dropped
+				as->dev->step = 0;
+				as->dev->wait_us = 0;
+				as->dev->error = BME280_ERR_CONFIG;
+				break;
+			}
+			as->start_timer(as, as->dev->wait_us);	//BME280_AsyncTimer goes on
+		} else if (as->port->status == PORT_FREE) {
+			continue;
+		}
+		//transfer or timer started: BME280_AsyncIRQ or BME280_AsyncTimer goes on,
+		//unless it already came while running was set
+		as->running = 0;
+		if (!as->kick) {
+			return;
+		}
+		as->running = 1;
+	}
+	as->running = 0;
+	finish(as);
+}
+
+/*!
+ *  @brief This API starts an operation: op is a step function of the
+ *  driver (BME280_Init, BME280_GetData, BME280_Configure...). Its first
+ *  transfer is started here, the next ones by BME280_AsyncIRQ, done is
+ *  called from the interrupt at the end. A wait step (forced mode
+ *  conversion, reset start-up) starts as->start_timer and nothing runs
+ *  until BME280_AsyncTimer, without a timer the operation ends with
+ *  BME280_ERR_CONFIG. Returns 0 if the port is not free or an operation
+ *  is running.
+ */
+uint8_t BME280_AsyncStart(bme280_async *as, uint8_t (*op)(I2C_Connection *_i2c, BME280_t *dev),
+		void (*done)(BME280_t *dev, void *ctx), void *ctx) {
+	if (as->op || as->port->status != PORT_FREE) {
+		return 0;
+	}
+	as->done = done;
+	as->ctx = ctx;
+	as->dev->step = 0;
+	as->dev->error = BME280_ERR_NONE;
+	as->op = op;
+	advance(as);
+	return 1;
+}
+
+/*!
+ *  @brief This API reads the calibration and sets the sensor up, done
+ *  is called with dev->status OK or dev->error set.
+ */
+uint8_t BME280_InitAsync(bme280_async *as, void (*done)(BME280_t *dev, void *ctx), void *ctx) {
+	return BME280_AsyncStart(as, BME280_Init, done, ctx);
+}
+
+/*!
+ *  @brief This API reads one sample, a forced mode measurement for a
+ *  sensor set up in forced mode (needs as->start_timer for the conversion
+ *  time). done is called with the new data.
+ */
+uint8_t BME280_GetDataAsync(bme280_async *as, void (*done)(BME280_t *dev, void *ctx), void *ctx) {
+	if (as->dev->config.mode == BME280_FORCED_MODE) {
+		return BME280_AsyncStart(as, BME280_GetDataForced, done, ctx);
+	}
+	return BME280_AsyncStart(as, BME280_GetData, done, ctx);
+}
+
+/*!
+ *  @brief This API advances the running operation, call it from the
+ *  completion interrupt (or callback) of the port after the status is set.
+ *  A port error ends the operation with dev->error BME280_ERR_BUS and the
+ *  port back to PORT_FREE, BME280_Recover can be started the same way.
+ *  A transport that completes inside its start call may call it from
+ *  there. Nothing is done when no operation runs.
+ */
+void BME280_AsyncIRQ(bme280_async *as) {
+	if (!as->op) {
+		return;
+	}
+	if (as->running) {
+		as->kick = 1;
+		return;
+	}
+	advance(as);
+}
+
+/*!
+ *  @brief This API goes on after a wait step, call it from the interrupt
+ *  of the timer started by as->start_timer. Nothing is done when no
+ *  operation runs.
+ */
+void BME280_AsyncTimer(bme280_async *as) {
+	if (!as->op) {
+		return;
+	}
+	if (as->running) {
+		as->kick = 1;
+		return;
+	}
+	advance(as);
+}
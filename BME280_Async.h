@@ -0,0 +1,55 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	BME280_Async.h
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+#ifndef BME280_BME280_ASYNC_H_
+#define BME280_BME280_ASYNC_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "BME280.h"
+//===========================================================================================
+/*!
+ * @brief Event driven operation of one sensor. The application owns it
+ * (static or on the stack of a task), sets port, dev and start_timer and
+ * calls BME280_AsyncIRQ from the completion interrupt of the port and
+ * BME280_AsyncTimer from the timer interrupt.
+ */
+typedef struct bme280_async_t {
+		I2C_Connection *port;
+		BME280_t *dev;
+		void (*start_timer)(struct bme280_async_t *as, uint32_t us);	// One-shot timer for the wait steps (forced mode conversion, reset), NULL if not used
+		uint8_t (* volatile op)(I2C_Connection *_i2c, BME280_t *dev);	// Running operation, NULL when idle
+		void (*done)(BME280_t *dev, void *ctx);	// Called when the operation ends, dev->error tells the result
+		void *ctx;
+		volatile uint8_t running;	// Internal: steps running, an interrupt now only sets kick
+		volatile uint8_t kick;		// Internal: transfer or timer ended while running was set
+} bme280_async;
+
+uint8_t BME280_AsyncStart(bme280_async *as, uint8_t (*op)(I2C_Connection *_i2c, BME280_t *dev),
+		void (*done)(BME280_t *dev, void *ctx), void *ctx);
+uint8_t BME280_InitAsync(bme280_async *as, void (*done)(BME280_t *dev, void *ctx), void *ctx);
+uint8_t BME280_GetDataAsync(bme280_async *as, void (*done)(BME280_t *dev, void *ctx), void *ctx);
+void BME280_AsyncIRQ(bme280_async *as);
+void BME280_AsyncTimer(bme280_async *as);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* BME280_BME280_ASYNC_H_ */
@@ -0,0 +1,164 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	BME280_Filter.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+#include "BME280_Filter.h"
+#include <string.h>
+
+/*!
+ *  @brief This API sets up the filter. n is the window length (1 to
+ *  BME280_FILTER_MAX_N) for the moving average and the median, an even n
+ *  is lowered to the next odd length for the median so it has a middle
+ *  sample, and the shift (1 to BME280_FILTER_IIR_MAX_SHIFT) for the IIR
+ *  filter: coefficient 2^n like the BME280_FILTER_COEFF values. A larger
+ *  shift would leave a deadband of more than 1/2 LSB in the state, it is
+ *  lowered. The state starts empty.
+ */
+void BME280_FilterInit(bme280_filter *flt, uint8_t type, uint8_t n, uint8_t decim) {
+	memset(flt, 0, sizeof(*flt));
+	if (type == BME280_FILTER_IIR) {
+		n = (n < 1) ? 1 : (n > BME280_FILTER_IIR_MAX_SHIFT ? BME280_FILTER_IIR_MAX_SHIFT : n);
+	} else {
+		n = (n < 1) ? 1 : (n > BME280_FILTER_MAX_N ? BME280_FILTER_MAX_N : n);
+		if (type == BME280_FILTER_MEDIAN && (n & 1) == 0) {
+			n--;
+		}
+	}
+	flt->type = type;
+	flt->n = n;
+	flt->decim = decim;
+}
+
+static int32_t average(bme280_filter_ch *c, uint8_t n, int32_t x) {
+	if (c->count == n) {
+		c->sum -= c->win[c->pos];
+	} else {
+		c->count++;
+	}
+	c->win[c->pos] = x;
+	c->sum += x;
+	c->pos = (uint8_t)((c->pos + 1) % n);
+	//round half away from zero
+	return (c->sum >= 0 ? c->sum + c->count / 2 : c->sum - c->count / 2) / c->count;
+}
+
+//rounded increment: the state stops within 2^(shift - 1) of xs, less than 1/4 LSB
+static inline int32_t iir_step(int32_t acc, int32_t xs, uint8_t shift) {
+	return acc + ((xs - acc + (1 << (shift - 1))) >> shift);
+}
+
+//first sample loads the state, the output settles without a step from zero
+static int32_t iir(bme280_filter_ch *c, uint8_t shift, int32_t x) {
+	int32_t xs = x * (1 << BME280_FILTER_IIR_FRAC);
+
+	if (c->count == 0) {
+		c->acc = xs;
+		c->count = 1;
+	} else {
+		c->acc = iir_step(c->acc, xs, shift);
+	}
+	return (c->acc + (1 << (BME280_FILTER_IIR_FRAC - 1))) >> BME280_FILTER_IIR_FRAC;
+}
+
+static int32_t median(bme280_filter_ch *c, uint8_t n, int32_t x) {
+	int32_t s[BME280_FILTER_MAX_N];
+	int32_t v;
+	uint8_t i, j;
+
+	c->win[c->pos] = x;
+	c->pos = (uint8_t)((c->pos + 1) % n);
+	if (c->count < n) {
+		c->count++;
+	}
+	//insertion sort, the window is short
+	for (i = 0; i < c->count; i++) {
+		v = c->win[i];
+		for (j = i; j > 0 && s[j - 1] > v; j--) {
+			s[j] = s[j - 1];
+		}
+		s[j] = v;
+	}
+	return s[c->count / 2];
+}
+
+/*!
+ *  @brief This API filters one sample of one channel and returns the output.
+ *  The IIR state holds the value with BME280_FILTER_IIR_FRAC fraction bits,
+ *  the filter takes values up to +-2^18, pressure in Pa and humidity in
+ *  1/1024 %RH fit.
+ */
+int32_t BME280_FilterChannel(bme280_filter *flt, uint8_t ch, int32_t x) {
+	bme280_filter_ch *c = &flt->ch[ch];
+
+	switch (flt->type) {
+	case BME280_FILTER_AVERAGE:
+		return average(c, flt->n, x);
+	case BME280_FILTER_IIR:
+		return iir(c, flt->n, x);
+	case BME280_FILTER_MEDIAN:
+		return median(c, flt->n, x);
+	default:
+		return x;
+	}
+}
+
+/*!
+ *  @brief This API filters the three channels of a BME280_GetData sample.
+ *  It returns 1 when out holds a new output, every decim-th sample,
+ *  so BME280_FILTER_AVERAGE with n == decim is a decimator of the stream.
+ */
+uint8_t BME280_FilterApply(bme280_filter *flt, const bme280_data_int *in, bme280_data_int *out) {
+	int32_t t = BME280_FilterChannel(flt, BME280_CH_TEMPERATURE, in->temperature);
+	int32_t p = BME280_FilterChannel(flt, BME280_CH_PRESSURE, (int32_t)in->pressure);
+	int32_t h = BME280_FilterChannel(flt, BME280_CH_HUMIDITY, (int32_t)in->humidity);
+
+	if (flt->decim > 1) {
+		if (++flt->phase < flt->decim) {
+			return 0;
+		}
+		flt->phase = 0;
+	}
+	out->temperature = t;
+	out->pressure = (uint32_t)p;
+	out->humidity = (uint32_t)h;
+	return 1;
+}
+
+/*!
+ *  @brief This API runs the IIR filter over archived multi-sensor data.
+ *  in and out hold len rows of streams interleaved values (one row per time
+ *  step), acc holds one state per stream in the BME280_FILTER_IIR_FRAC
+ *  format, load it with value << BME280_FILTER_IIR_FRAC to start. shift is
+ *  limited to BME280_FILTER_IIR_MAX_SHIFT like in BME280_FilterInit. The
+ *  inner loop runs across the streams without dependencies and is
+ *  vectorized by the compiler.
+ */
+void BME280_FilterIIRBatch(int32_t *acc, const int32_t *in, int32_t *out,
+		uint32_t streams, uint32_t len, uint8_t shift) {
+	uint32_t i, s;
+
+	shift = (shift < 1) ? 1 : (shift > BME280_FILTER_IIR_MAX_SHIFT ? BME280_FILTER_IIR_MAX_SHIFT : shift);
+	for (i = 0; i < len; i++) {
+		for (s = 0; s < streams; s++) {
+			acc[s] = iir_step(acc[s], in[s] * (1 << BME280_FILTER_IIR_FRAC), shift);
+			out[s] = (acc[s] + (1 << (BME280_FILTER_IIR_FRAC - 1))) >> BME280_FILTER_IIR_FRAC;
+		}
+		in += streams;
+		out += streams;
+	}
+}
@@ -0,0 +1,77 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	BME280_Filter.h
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+#ifndef BME280_BME280_FILTER_H_
+#define BME280_BME280_FILTER_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "BME280.h"
+//===========================================================================================
+#define BME280_FILTER_MAX_N		15	//longest moving average and median window
+#define BME280_FILTER_IIR_FRAC	12	//fraction bits of the IIR state
+#define BME280_FILTER_IIR_MAX_SHIFT	(BME280_FILTER_IIR_FRAC - 1)	//the rounded state settles within 1/4 LSB of the input
+
+enum BME280_FILTER_TYPE {
+	BME280_FILTER_NONE		= 0x00,
+	BME280_FILTER_AVERAGE	= 0x01,	//moving average of the last n samples
+	BME280_FILTER_IIR		= 0x02,	//y += (x - y) / 2^n, like the on-chip filter
+	BME280_FILTER_MEDIAN	= 0x03	//median of the last n samples, rejects spikes
+};
+
+enum BME280_CHANNEL {
+	BME280_CH_TEMPERATURE	= 0x00,
+	BME280_CH_PRESSURE		= 0x01,
+	BME280_CH_HUMIDITY		= 0x02
+};
+
+/*!
+ * @brief Filter state of one channel
+ */
+typedef struct bme280_filter_ch_t {
+		int32_t win[BME280_FILTER_MAX_N];	// Last samples, moving average and median
+		int32_t sum;					// Sum of win, moving average
+		int32_t acc;					// IIR output with BME280_FILTER_IIR_FRAC fraction bits
+		uint8_t pos;					// Next slot of win
+		uint8_t count;					// Samples in win, IIR started when not 0
+} bme280_filter_ch;
+
+/*!
+ * @brief Software filter and decimator of the integer compensated data.
+ * Integer only, runs on MCUs without FPU.
+ */
+typedef struct bme280_filter_t {
+		uint8_t type;				// BME280_FILTER_TYPE
+		uint8_t n;					// Window length or IIR shift
+		uint8_t decim;				// Output every decim-th sample, 0 and 1 output all
+		uint8_t phase;
+		bme280_filter_ch ch[3];		// BME280_CHANNEL
+} bme280_filter;
+
+void BME280_FilterInit(bme280_filter *flt, uint8_t type, uint8_t n, uint8_t decim);
+int32_t BME280_FilterChannel(bme280_filter *flt, uint8_t ch, int32_t x);
+uint8_t BME280_FilterApply(bme280_filter *flt, const bme280_data_int *in, bme280_data_int *out);
+void BME280_FilterIIRBatch(int32_t *acc, const int32_t *in, int32_t *out,
+		uint32_t streams, uint32_t len, uint8_t shift);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* BME280_BME280_FILTER_H_ */
@@ -0,0 +1,195 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	BME280_Log.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+#include "BME280_Log.h"
+#include <string.h>
+
+//RING	==========================================================================
+/*!
+ *  @brief This API sets up an empty ring over buf of size entries,
+ *  size must be a power of two.
+ */
+void BME280_LogInit(bme280_log *log, bme280_log_entry *buf, uint16_t size, uint32_t (*timestamp)(void)) {
+	log->buf = buf;
+	log->mask = (uint16_t)(size - 1);
+	log->head = 0;
+	log->tail = 0;
+	log->dropped = 0;
+	log->timestamp = timestamp;
+}
+
+static void log_raw(void *ctx, const bme280_uncomp_data *raw) {
+	BME280_LogPush((bme280_log *)ctx, raw);
+}
+
+/*!
+ *  @brief This API makes the sample completions of a sensor push every new
+ *  raw sample into log (dev->on_raw hook), NULL detaches it.
+ */
+void BME280_LogAttach(BME280_t *dev, bme280_log *log) {
+	dev->raw_ctx = log;
+	dev->on_raw = log ? log_raw : 0;
+}
+
+/*!
+ *  @brief Producer side, safe to call from the port interrupt.
+ *  Returns 0 and counts a dropped sample if the ring is full.
+ */
+uint8_t BME280_LogPush(bme280_log *log, const bme280_uncomp_data *raw) {
+	uint16_t head = log->head;
+	bme280_log_entry *e;
+
+	if (((head + 1) & log->mask) == log->tail) {
+		log->dropped++;
+		return 0;
+	}
+	e = &log->buf[head];
+	e->timestamp = log->timestamp ? log->timestamp() : 0;
+	e->raw = *raw;
+	BME280_LOG_BARRIER();
+	log->head = (uint16_t)((head + 1) & log->mask);
+	return 1;
+}
+
+/*!
+ *  @brief Consumer side. Returns 0 if the ring is empty.
+ */
+uint8_t BME280_LogPop(bme280_log *log, bme280_log_entry *entry) {
+	uint16_t tail = log->tail;
+
+	if (tail == log->head) {
+		return 0;
+	}
+	BME280_LOG_BARRIER();
+	*entry = log->buf[tail];
+	BME280_LOG_BARRIER();
+	log->tail = (uint16_t)((tail + 1) & log->mask);
+	return 1;
+}
+
+uint16_t BME280_LogCount(const bme280_log *log) {
+	return (uint16_t)((log->head - log->tail) & log->mask);
+}
+//PACK	==========================================================================
+static uint8_t put_varint(uint8_t *dt, uint32_t prev, uint32_t val) {
+	int32_t delta = (int32_t)(val - prev);
+	uint32_t zz = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+	uint8_t len = 0;
+
+	while (zz >= 0x80) {
+		dt[len++] = (uint8_t)(zz | 0x80);
+		zz >>= 7;
+	}
+	dt[len++] = (uint8_t)zz;
+	return len;
+}
+
+static uint8_t get_varint(bme280_pack *pack, uint32_t *val) {
+	uint32_t zz = 0;
+	uint8_t shift = 0;
+	uint8_t b;
+
+	do {
+		if (pack->len >= pack->size || shift > 28) {
+			return 0;
+		}
+		b = pack->buf[pack->len++];
+		zz |= (uint32_t)(b & 0x7F) << shift;
+		shift += 7;
+	} while (b & 0x80);
+	*val += (zz >> 1) ^ (0U - (zz & 1));
+	return 1;
+}
+
+/*!
+ *  @brief This API starts an empty packed block in buf.
+ */
+void BME280_PackInit(bme280_pack *pack, uint8_t *buf, uint16_t size) {
+	pack->buf = buf;
+	pack->size = size;
+	pack->len = 0;
+	memset(&pack->last, 0, sizeof(pack->last));
+}
+
+/*!
+ *  @brief This API appends one entry to the block.
+ *  Returns 0 and leaves the block unchanged if it does not fit.
+ */
+uint8_t BME280_PackPut(bme280_pack *pack, const bme280_log_entry *entry) {
+	uint8_t dt[BME280_PACK_MAX_LEN];
+	uint8_t len;
+
+	len = put_varint(dt, pack->last.timestamp, entry->timestamp);
+	len += put_varint(&dt[len], pack->last.raw.pressure, entry->raw.pressure);
+	len += put_varint(&dt[len], pack->last.raw.temperature, entry->raw.temperature);
+	len += put_varint(&dt[len], pack->last.raw.humidity, entry->raw.humidity);
+	if (pack->len + len > pack->size) {
+		return 0;
+	}
+	memcpy(&pack->buf[pack->len], dt, len);
+	pack->len += len;
+	pack->last = *entry;
+	return 1;
+}
+
+/*!
+ *  @brief This API moves entries from the ring into the block until the
+ *  ring is empty or the block is full. Returns the number of entries moved.
+ */
+uint16_t BME280_PackDrain(bme280_pack *pack, bme280_log *log) {
+	uint16_t cnt = 0;
+	uint16_t tail;
+
+	while ((tail = log->tail) != log->head) {
+		BME280_LOG_BARRIER();
+		if (!BME280_PackPut(pack, &log->buf[tail])) {
+			break;
+		}
+		BME280_LOG_BARRIER();
+		log->tail = (uint16_t)((tail + 1) & log->mask);
+		cnt++;
+	}
+	return cnt;
+}
+
+/*!
+ *  @brief This API starts reading a packed block of len bytes.
+ */
+void BME280_UnpackInit(bme280_pack *pack, const uint8_t *buf, uint16_t len) {
+	pack->buf = (uint8_t *)buf;
+	pack->size = len;
+	pack->len = 0;
+	memset(&pack->last, 0, sizeof(pack->last));
+}
+
+/*!
+ *  @brief This API decodes the next entry of the block.
+ *  Returns 0 at the end of the block or on a truncated entry.
+ */
+uint8_t BME280_UnpackGet(bme280_pack *pack, bme280_log_entry *entry) {
+	bme280_log_entry e = pack->last;
+
+	if (!get_varint(pack, &e.timestamp) || !get_varint(pack, &e.raw.pressure)
+			|| !get_varint(pack, &e.raw.temperature) || !get_varint(pack, &e.raw.humidity)) {
+		return 0;
+	}
+	pack->last = e;
+	*entry = e;
+	return 1;
+}
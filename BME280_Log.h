@@ -0,0 +1,82 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	BME280_Log.h
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+#ifndef BME280_BME280_LOG_H_
+#define BME280_BME280_LOG_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "BME280.h"
+//===========================================================================================
+//orders the entry write before the index update seen by the other side
+#ifndef BME280_LOG_BARRIER
+#define BME280_LOG_BARRIER()	__sync_synchronize()
+#endif
+
+#define BME280_PACK_MAX_LEN	20	//worst case packed entry size, 4 varints of 5 bytes
+
+typedef struct bme280_log_entry_t {
+		uint32_t timestamp;
+		bme280_uncomp_data raw;
+} bme280_log_entry;
+
+/*!
+ * @brief Single producer, single consumer ring of raw samples.
+ * The producer (the BME280_GetData completion) only writes head, the
+ * consumer only writes tail, so no lock is needed.
+ * size must be a power of two, one slot is kept free.
+ */
+typedef struct bme280_log_t {
+		bme280_log_entry *buf;
+		uint16_t mask;
+		volatile uint16_t head;		// Next slot to write
+		volatile uint16_t tail;		// Next slot to read
+		uint32_t dropped;			// Samples lost because the ring was full
+		uint32_t (*timestamp)(void);	// Time source for new entries, may be NULL
+} bme280_log;
+
+/*!
+ * @brief Delta encoder: each entry is stored as zigzag varints of the
+ * differences to the previous entry (timestamp, pressure, temperature,
+ * humidity), usually 4-6 bytes per sample instead of 16.
+ */
+typedef struct bme280_pack_t {
+		uint8_t *buf;
+		uint16_t size;
+		uint16_t len;				// Bytes used
+		bme280_log_entry last;		// Previous entry, zero at the start of a block
+} bme280_pack;
+
+void BME280_LogInit(bme280_log *log, bme280_log_entry *buf, uint16_t size, uint32_t (*timestamp)(void));
+void BME280_LogAttach(BME280_t *dev, bme280_log *log);
+uint8_t BME280_LogPush(bme280_log *log, const bme280_uncomp_data *raw);
+uint8_t BME280_LogPop(bme280_log *log, bme280_log_entry *entry);
+uint16_t BME280_LogCount(const bme280_log *log);
+
+void BME280_PackInit(bme280_pack *pack, uint8_t *buf, uint16_t size);
+uint8_t BME280_PackPut(bme280_pack *pack, const bme280_log_entry *entry);
+uint16_t BME280_PackDrain(bme280_pack *pack, bme280_log *log);
+void BME280_UnpackInit(bme280_pack *pack, const uint8_t *buf, uint16_t len);
+uint8_t BME280_UnpackGet(bme280_pack *pack, bme280_log_entry *entry);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* BME280_BME280_LOG_H_ */
@@ -0,0 +1,203 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	BME280_Metrics.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+#include "BME280_Metrics.h"
+
+#define Q30				(1LL << 30)
+#define LN2_Q30			744261118LL		//ln(2)
+#define BARO_EXP_Q30	204293341LL		//0.190263, barometric formula exponent
+#define INV_LN2_Q22		6051102LL		//1 / ln(2)
+#define BARO_INV_FRAC_Q30	274751900LL	//1 / 0.190263 - 5, the integer part is a shift and add
+#define MAGNUS_B		1762LL			//Magnus b 17.62, scaled by 100
+#define MAGNUS_C		24312LL			//Magnus c 243.12 degC, in 0.01 degC
+
+//1 / n in Q30 for the Taylor series of exp_q30
+static const uint32_t inv_tab[10] = {
+	0, 1073741824, 536870912, 357913941, 268435456, 214748365, 178956971, 153391689, 134217728, 119304647
+};
+
+//log2(1 + i / 256) in Q30, the mantissa part of ln_q30
+static const uint32_t log2_tab[258] = {
+	0, 6039314, 12055174, 18047761, 24017256, 29963836,
+	35887675, 41788947, 47667823, 53524472, 59359063, 65171760,
+	70962728, 76732128, 82480119, 88206862, 93912511, 99597222,
+	105261148, 110904440, 116527248, 122129721, 127712004, 133274244,
+	138816582, 144339162, 149842124, 155325606, 160789745, 166234679,
+	171660541, 177067464, 182455581, 187825021, 193175914, 198508388,
+	203822568, 209118580, 214396548, 219656594, 224898839, 230123404,
+	235330407, 240519966, 245692198, 250847218, 255985140, 261106077,
+	266210141, 271297442, 276368092, 281422197, 286459867, 291481207,
+	296486323, 301475319, 306448299, 311405366, 316346620, 321272163,
+	326182095, 331076513, 335955515, 340819199, 345667660, 350500993,
+	355319292, 360122651, 364911162, 369684916, 374444004, 379188517,
+	383918542, 388634168, 393335482, 398022572, 402695523, 407354420,
+	411999347, 416630388, 421247625, 425851141, 430441017, 435017334,
+	439580170, 444129607, 448665721, 453188592, 457698295, 462194908,
+	466678506, 471149164, 475606957, 480051959, 484484242, 488903880,
+	493310944, 497705506, 502087636, 506457405, 510814882, 515160136,
+	519493235, 523814248, 528123241, 532420281, 536705435, 540978767,
+	545240343, 549490228, 553728485, 557955178, 562170370, 566374123,
+	570566499, 574747559, 578917365, 583075977, 587223455, 591359858,
+	595485245, 599599675, 603703206, 607795895, 611877800, 615948977,
+	620009483, 624059373, 628098702, 632127527, 636145900, 640153876,
+	644151509, 648138853, 652115959, 656082880, 660039669, 663986377,
+	667923055, 671849754, 675766525, 679673418, 683570481, 687457766,
+	691335320, 695203192, 699061430, 702910083, 706749198, 710578822,
+	714399001, 718209783, 722011213, 725803337, 729586201, 733359850,
+	737124328, 740879680, 744625951, 748363183, 752091421, 755810707,
+	759521085, 763222597, 766915285, 770599192, 774274358, 777940826,
+	781598637, 785247830, 788888448, 792520529, 796144114, 799759243,
+	803365955, 806964289, 810554283, 814135978, 817709409, 821274617,
+	824831638, 828380510, 831921271, 835453956, 838978604, 842495250,
+	846003931, 849504683, 852997541, 856482542, 859959719, 863429109,
+	866890747, 870344666, 873790901, 877229486, 880660455, 884083842,
+	887499680, 890908003, 894308843, 897702233, 901088206, 904466794,
+	907838029, 911201944, 914558569, 917907937, 921250079, 924585025,
+	927912807, 931233456, 934547002, 937853475, 941152905, 944445323,
+	947730758, 951009239, 954280797, 957545460, 960803257, 964054218,
+	967298370, 970535742, 973766362, 976990259, 980207461, 983417995,
+	986621888, 989819169, 993009864, 996194001, 999371606, 1002542707,
+	1005707329, 1008865499, 1012017244, 1015162589, 1018301561, 1021434185,
+	1024560487, 1027680492, 1030794226, 1033901713, 1037002979, 1040098049,
+	1043186948, 1046269699, 1049346328, 1052416858, 1055481314, 1058539720,
+	1061592099, 1064638476, 1067678873, 1070713315, 1073741824, 1076764424
+};
+
+/*!
+ *  @brief This internal API returns ln(x) in Q30 for x > 0. The mantissa
+ *  log2 comes from the table with quadratic interpolation, error < 1e-8.
+ */
+static int64_t ln_q30(uint32_t x) {
+	uint8_t msb = 31;
+	uint8_t s;
+	uint32_t m = x;
+	uint32_t idx;
+	int64_t r;
+	int64_t frac;
+
+	for (s = 16; s > 0; s >>= 1) {//normalize to bit 31
+		if (!(m >> (32 - s))) {
+			m <<= s;
+			msb -= s;
+		}
+	}
+	idx = (m >> 23) & 0xFF;
+	r = m & 0x7FFFFF;
+	//Newton forward differences: t0 + r * d1 + r * (r - 1) / 2 * d2
+	frac = log2_tab[idx] + ((r * (int64_t)(log2_tab[idx + 1] - log2_tab[idx])) >> 23)
+			+ (((r * (r - 0x800000) >> 23) * ((int64_t)log2_tab[idx + 2] - 2 * (int64_t)log2_tab[idx + 1] + log2_tab[idx])) >> 24);
+	return (int64_t)msb * LN2_Q30 + ((frac * LN2_Q30) >> 30);
+}
+
+/*!
+ *  @brief This internal API returns e^x in Q30 for x in Q30, -40 < x < 22.5.
+ *  x = k * ln2 + r with |r| <= ln2 / 2, e^r by its Taylor series.
+ */
+static int64_t exp_q30(int64_t x) {
+	int64_t k;
+	int64_t r;
+	int64_t p = Q30;
+	uint8_t n;
+
+	k = ((x >> 8) * INV_LN2_Q22 + (1LL << 43)) >> 44;	//round(x / ln2) without a 64 bit division
+	r = x - k * LN2_Q30;
+	for (n = 9; n > 0; n--) {
+		p = Q30 + (((r * p) >> 30) * inv_tab[n] >> 30);
+	}
+	return (k >= 0) ? (p << k) : (p >> -k);
+}
+
+/*!
+ *  @brief This API returns the barometric altitude in cm for the pressure
+ *  and the sea level pressure p0 in Pa:
+ *  44330 m * (1 - (p / p0)^0.190263). Error < 1 cm.
+ */
+int32_t BME280_Altitude(uint32_t pressure, uint32_t p0) {
+	int64_t u;
+
+	if (pressure == 0 || p0 == 0) {
+		return 0;
+	}
+	u = ((ln_q30(pressure) - ln_q30(p0)) * BARO_EXP_Q30) >> 30;
+	return (int32_t)((4433000LL * (Q30 - exp_q30(u)) + Q30 / 2) >> 30);
+}
+
+/*!
+ *  @brief This API returns the sea level pressure in Pa for the pressure in
+ *  Pa measured at the altitude in cm: p / (1 - h / 44330 m)^5.25588.
+ *  Valid for any altitude below 44330 m, results above UINT32_MAX and
+ *  altitudes of 44330 m and more (no finite value) return UINT32_MAX.
+ *  Error < 1 Pa up to 9 km, relative error < 1e-7 past the rounding above.
+ */
+uint32_t BME280_SeaLevelPressure(uint32_t pressure, int32_t altitude) {
+	int64_t ln;
+	int64_t v;
+	int64_t r;
+
+	if (altitude >= 4433000) {
+		return UINT32_MAX;
+	}
+	if (pressure == 0) {
+		return 0;
+	}
+	//ln((44330 m - h) / 44330 m) is in [-15.4, 6.2], times 5.25588 in two parts to stay in 64 bit
+	ln = ln_q30((uint32_t)4433000 - (uint32_t)altitude) - ln_q30(4433000);
+	v = -(ln * 5 + ((ln * BARO_INV_FRAC_Q30) >> 30));
+	if (v + ln_q30(pressure) >= 32 * LN2_Q30) {//p * e^v >= 2^32
+		return UINT32_MAX;
+	}
+	r = (pressure * exp_q30(v) + Q30 / 2) >> 30;
+	return (r > UINT32_MAX) ? UINT32_MAX : (uint32_t)r;
+}
+
+//ln(RH / 100) + b * T / (c + T) of the Magnus formula, Q30
+static int64_t magnus_gamma(int32_t temperature, uint32_t humidity) {
+	if (humidity == 0) {
+		humidity = 1;
+	}
+	return ln_q30(humidity) - ln_q30(102400) + (MAGNUS_B * temperature * Q30) / (100 * (MAGNUS_C + temperature));
+}
+
+/*!
+ *  @brief This API returns the dew point in 0.01 degC from the temperature
+ *  in 0.01 degC and the humidity in 1/1024 %RH by the Magnus formula
+ *  (b = 17.62, c = 243.12 degC). Error < 0.01 degC against the formula, the
+ *  formula itself is within 0.35 degC of the exact dew point.
+ */
+int32_t BME280_DewPoint(int32_t temperature, uint32_t humidity) {
+	int64_t gamma = magnus_gamma(temperature, humidity);
+	int64_t den = MAGNUS_B * Q30 / 100 - gamma;
+	int64_t num = MAGNUS_C * gamma;
+
+	return (int32_t)((num >= 0 ? num + den / 2 : num - den / 2) / den);
+}
+
+/*!
+ *  @brief This API returns the absolute humidity in mg/m3 from the
+ *  temperature in 0.01 degC and the humidity in 1/1024 %RH:
+ *  216.74 * e / T(K) with the vapour pressure e = 6.112 hPa * e^gamma = RH * es(T).
+ *  Error < 1 mg/m3.
+ */
+uint32_t BME280_AbsoluteHumidity(int32_t temperature, uint32_t humidity) {
+	int64_t e;
+
+	//vapour pressure in hPa, Q20
+	e = (exp_q30(magnus_gamma(temperature, humidity)) * 6112 / 1000) >> 10;
+	return (uint32_t)((21674000LL * e / (27315 + temperature) + (1 << 19)) >> 20);
+}
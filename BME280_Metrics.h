@@ -0,0 +1,42 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	BME280_Metrics.h
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+#ifndef BME280_BME280_METRICS_H_
+#define BME280_BME280_METRICS_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "BME280.h"
+//===========================================================================================
+#define BME280_SEA_LEVEL_PRESSURE	101325	//standard atmosphere, Pa
+
+/* Derived values from the integer compensated data (bme280_data_int units:
+ * temperature 0.01 degC, pressure Pa, humidity 1/1024 %RH) in fixed point,
+ * no float and no libm. The error bounds are against the same formulas in
+ * double over the sensor range (300-1100 hPa, -40..85 degC, 1-100 %RH). */
+int32_t BME280_Altitude(uint32_t pressure, uint32_t p0);
+uint32_t BME280_SeaLevelPressure(uint32_t pressure, int32_t altitude);
+int32_t BME280_DewPoint(int32_t temperature, uint32_t humidity);
+uint32_t BME280_AbsoluteHumidity(int32_t temperature, uint32_t humidity);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* BME280_BME280_METRICS_H_ */
@@ -0,0 +1,185 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	BME280_Record.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+#include "BME280_Record.h"
+#include <string.h>
+
+static const uint8_t rec_magic[4] = {'B', 'M', 'E', 'R'};
+
+//WRITER	========================================================================
+/*!
+ *  @brief This API starts a recording in buf with the file header.
+ */
+void BME280_RecInit(bme280_rec_writer *wr, uint8_t *buf, uint32_t size) {
+	wr->buf = buf;
+	wr->size = size;
+	wr->len = 0;
+	if (size >= BME280_REC_HEADER_LEN) {
+		memcpy(buf, rec_magic, 4);
+		buf[4] = BME280_REC_VERSION;
+		buf[5] = 0;
+		buf[6] = 0;
+		buf[7] = 0;
+		wr->len = BME280_REC_HEADER_LEN;
+	}
+}
+
+/*!
+ *  @brief This API empties the buffer after the application stored it,
+ *  the next records continue the same recording.
+ */
+void BME280_RecClear(bme280_rec_writer *wr) {
+	wr->len = 0;
+}
+
+/*!
+ *  @brief This API records the calibration of a sensor, write it before
+ *  the frames of the sensor and again after a change.
+ *  Returns 0 if the buffer is full.
+ */
+uint8_t BME280_RecCalib(bme280_rec_writer *wr, uint8_t sensor, const BME280_t *dev) {
+	uint8_t *dt;
+
+	if (wr->len + BME280_REC_CALIB_LEN > wr->size) {
+		return 0;
+	}
+	dt = &wr->buf[wr->len];
+	dt[0] = BME280_REC_CALIB;
+	dt[1] = sensor;
+	BME280_SaveCalib(dev, &dt[2]);
+	wr->len += BME280_REC_CALIB_LEN;
+	return 1;
+}
+
+/*!
+ *  @brief This API records one sample as the data register frame it was
+ *  read from, the reserved low bits of the xlsb bytes are 0.
+ *  Returns 0 if the buffer is full.
+ */
+uint8_t BME280_RecFrame(bme280_rec_writer *wr, uint8_t sensor, uint32_t timestamp, const bme280_uncomp_data *raw) {
+	uint8_t *dt;
+
+	if (wr->len + BME280_REC_FRAME_LEN > wr->size) {
+		return 0;
+	}
+	dt = &wr->buf[wr->len];
+	dt[0] = BME280_REC_FRAME;
+	dt[1] = sensor;
+	dt[2] = (uint8_t)timestamp;
+	dt[3] = (uint8_t)(timestamp >> 8);
+	dt[4] = (uint8_t)(timestamp >> 16);
+	dt[5] = (uint8_t)(timestamp >> 24);
+	dt[6] = (uint8_t)(raw->pressure >> 12);
+	dt[7] = (uint8_t)(raw->pressure >> 4);
+	dt[8] = (uint8_t)(raw->pressure << 4);
+	dt[9] = (uint8_t)(raw->temperature >> 12);
+	dt[10] = (uint8_t)(raw->temperature >> 4);
+	dt[11] = (uint8_t)(raw->temperature << 4);
+	dt[12] = (uint8_t)(raw->humidity >> 8);
+	dt[13] = (uint8_t)raw->humidity;
+	wr->len += BME280_REC_FRAME_LEN;
+	return 1;
+}
+//READER	========================================================================
+/*!
+ *  @brief This API starts reading a recording of size bytes in memory.
+ *  Returns 0 if it is not a recording of this version.
+ */
+uint8_t BME280_RecOpen(bme280_rec_reader *rd, const uint8_t *buf, uint32_t size) {
+	rd->buf = buf;
+	rd->size = size;
+	rd->pos = 0;
+	if (size < BME280_REC_HEADER_LEN || memcmp(buf, rec_magic, 4) != 0 || buf[4] != BME280_REC_VERSION) {
+		return 0;
+	}
+	rd->pos = BME280_REC_HEADER_LEN;
+	return 1;
+}
+
+/*!
+ *  @brief This API returns the next record without copying the payload.
+ *  Returns 0 at the end, on a truncated or an unknown record.
+ */
+uint8_t BME280_RecNext(bme280_rec_reader *rd, bme280_rec_item *item) {
+	const uint8_t *dt = &rd->buf[rd->pos];
+	uint32_t left = rd->size - rd->pos;
+
+	if (left < 2) {
+		return 0;
+	}
+	item->type = dt[0];
+	item->sensor = dt[1];
+	if (dt[0] == BME280_REC_CALIB && left >= BME280_REC_CALIB_LEN) {
+		item->timestamp = 0;
+		item->data = &dt[2];
+		rd->pos += BME280_REC_CALIB_LEN;
+		return 1;
+	}
+	if (dt[0] == BME280_REC_FRAME && left >= BME280_REC_FRAME_LEN) {
+		item->timestamp = (uint32_t)dt[2] | ((uint32_t)dt[3] << 8) | ((uint32_t)dt[4] << 16) | ((uint32_t)dt[5] << 24);
+		item->data = &dt[6];
+		rd->pos += BME280_REC_FRAME_LEN;
+		return 1;
+	}
+	return 0;
+}
+
+/*!
+ *  @brief This API replays the rest of a recording into the sensors
+ *  dev[0..count-1]: calibration records restore the calibration, frames are
+ *  decoded and compensated as selected by dev->output and handed to
+ *  on_sample. wait is called with the frame timestamp before it, e.g. to
+ *  sleep until that time for a real time replay, NULL replays at full speed.
+ *  Frames before a valid calibration record of their sensor are skipped,
+ *  a corrupt calibration record drops the previous one as well.
+ *  Returns the number of frames replayed.
+ */
+uint32_t BME280_RecReplay(bme280_rec_reader *rd, BME280_t **dev, uint8_t count,
+		void (*wait)(uint32_t timestamp), void (*on_sample)(uint8_t sensor, uint32_t timestamp, BME280_t *dev)) {
+	bme280_rec_item item;
+	BME280_t *d;
+	uint32_t cnt = 0;
+
+	while (BME280_RecNext(rd, &item)) {
+		if (item.sensor >= count) {
+			continue;
+		}
+		d = dev[item.sensor];
+		if (item.type == BME280_REC_CALIB) {
+			if (!BME280_RestoreCalib(d, item.data)) {
+				d->calib_cached = 0;	//frames after it were measured with another calibration
+			}
+			continue;
+		}
+		if (!d->calib_cached) {//no valid calibration record yet
+			continue;
+		}
+		if (wait) {
+			wait(item.timestamp);
+		}
+		bme280_decode_sensor_data(item.data, &d->uncomp_data);
+		d->dirty = BME280_DIRTY_ALL;
+		bme280_calculate_data(d);
+		if (on_sample) {
+			on_sample(item.sensor, item.timestamp, d);
+		}
+		cnt++;
+	}
+	return cnt;
+}
@@ -0,0 +1,85 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	BME280_Record.h
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+#ifndef BME280_BME280_RECORD_H_
+#define BME280_BME280_RECORD_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "BME280.h"
+//===========================================================================================
+/* Recording of raw data frames and calibration blobs for offline replay.
+ * Little-endian byte stream:
+ * header	"BMER", version, 3 reserved bytes
+ * calib	BME280_REC_CALIB, sensor, calibration blob (BME280_SaveCalib)
+ * frame	BME280_REC_FRAME, sensor, timestamp (4 bytes), 8 bytes of BME280_REG_DATA */
+#define BME280_REC_VERSION		1
+#define BME280_REC_HEADER_LEN	8
+#define BME280_REC_CALIB_LEN	(2 + BME280_CALIB_BLOB_LEN)
+#define BME280_REC_FRAME_LEN	(6 + BME280_DATA_LEN)
+
+enum BME280_REC_TYPE {
+	BME280_REC_CALIB	= 0x01,
+	BME280_REC_FRAME	= 0x02
+};
+
+/*!
+ * @brief Writer into a memory buffer, the application stores the bytes
+ * (file, flash) and empties the buffer with BME280_RecClear.
+ */
+typedef struct bme280_rec_writer_t {
+		uint8_t *buf;
+		uint32_t size;
+		uint32_t len;			// Bytes used
+} bme280_rec_writer;
+
+/*!
+ * @brief Reader of a whole recording in memory, e.g. a mapped file.
+ */
+typedef struct bme280_rec_reader_t {
+		const uint8_t *buf;
+		uint32_t size;
+		uint32_t pos;			// Next record
+} bme280_rec_reader;
+
+/*!
+ * @brief One record, data points into the reader buffer
+ */
+typedef struct bme280_rec_item_t {
+		uint8_t type;			// BME280_REC_TYPE
+		uint8_t sensor;			// Index given by the writer
+		uint32_t timestamp;		// Frames only
+		const uint8_t *data;	// Calibration blob or data frame
+} bme280_rec_item;
+
+void BME280_RecInit(bme280_rec_writer *wr, uint8_t *buf, uint32_t size);
+void BME280_RecClear(bme280_rec_writer *wr);
+uint8_t BME280_RecCalib(bme280_rec_writer *wr, uint8_t sensor, const BME280_t *dev);
+uint8_t BME280_RecFrame(bme280_rec_writer *wr, uint8_t sensor, uint32_t timestamp, const bme280_uncomp_data *raw);
+
+uint8_t BME280_RecOpen(bme280_rec_reader *rd, const uint8_t *buf, uint32_t size);
+uint8_t BME280_RecNext(bme280_rec_reader *rd, bme280_rec_item *item);
+uint32_t BME280_RecReplay(bme280_rec_reader *rd, BME280_t **dev, uint8_t count,
+		void (*wait)(uint32_t timestamp), void (*on_sample)(uint8_t sensor, uint32_t timestamp, BME280_t *dev));
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* BME280_BME280_RECORD_H_ */
@@ -24,7 +24,8 @@
 //calib & data size
 enum BME280_Len {
 	BME280_T_P_CALIB_DATA_LEN	= 26,
-	BME280_HUM_CALIB_DATA_LEN	= 16,
+	BME280_HUM_CALIB_DATA_LEN	= 7,
+	BME280_ID_HUM_CALIB_DATA_LEN	= 24,	//chip id to the end of humidity calib 0xD0-0xE7
 	BME280_DATA_LEN				= 8
 };
 //BME280 registers address---------------------------------------------------------------------
@@ -32,7 +33,7 @@ enum BME280_REG {
 	BME280_REG_T_P_CALIB_DATA	= 0x88,	//calibration data 26 bytes
 	BME280_REG_CHIP_ID			= 0xD0,	//BME280 ID REGISTER
 	BME280_REG_RESET			= 0xE0,	//SOFTWARE RESET WRITE 0xB6 for reset chip
-	BME280_REG_HUM_CALIB_DATA	= 0xE1,	//16 bytes
+	BME280_REG_HUM_CALIB_DATA	= 0xE1,	//7 bytes
 	BME280_REG_CTRL_HUM			= 0xF2,	//bits for setup osrs hum
 	BME280_REG_STATUS			= 0xF3,	//status register
 	BME280_REG_CTRL_MEAS_PWR	= 0xF4,
@@ -0,0 +1,242 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	BME280_Sched.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+#include "BME280_Sched.h"
+
+/*!
+ *  @brief This API sets up the scheduler over a table of sensors.
+ *  The table entries must have port and dev filled in.
+ */
+void BME280_SchedInit(bme280_sched *sched, bme280_sched_entry *table, uint8_t count,
+		void (*on_sample)(uint8_t idx, BME280_t *dev), uint32_t (*millis)(void)) {
+	uint8_t i;
+
+	sched->table = table;
+	sched->count = count;
+	sched->next = 0;
+	sched->runs = 0;
+	sched->on_sample = on_sample;
+	sched->millis = millis;
+	sched->port_abort = 0;
+	for (i = 0; i < count; i++) {
+		table[i].owner = 0;
+		table[i].ready = 0;
+		table[i].dead = 0;
+		table[i].recover = 0;
+		table[i].faults = 0;
+		table[i].samples = 0;
+		table[i].dups = 0;
+		table[i].due_ms = 0;
+	}
+}
+
+//another entry is in the middle of an operation on the port
+static uint8_t port_taken(const bme280_sched *sched, uint8_t idx) {
+	uint8_t i;
+
+	for (i = 0; i < sched->count; i++) {
+		if (i != idx && sched->table[i].owner && sched->table[i].port == sched->table[idx].port) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+//next read may start: the sensor had time to finish a new cycle (normal mode) or the sample period passed (forced mode)
+static uint8_t read_due(const bme280_sched *sched, const bme280_sched_entry *e) {
+	if (!sched->millis || e->dev->step != 0) {
+		return 1;
+	}
+	return (int32_t)(sched->millis() - e->due_ms) >= 0;
+}
+
+//the driver waits (dev->wait_us, e.g. the forced conversion) and the time is not over yet
+static uint8_t waiting(const bme280_sched *sched, const bme280_sched_entry *e, uint32_t now) {
+	return sched->millis && e->dev->wait_us && (int32_t)(now - e->due_ms) < 0;
+}
+
+//operation runs longer than the measurement plus BME280_SCHED_TIMEOUT_MS
+static uint8_t timed_out(const bme280_sched *sched, const bme280_sched_entry *e, uint32_t now) {
+	const bme280_config *cfg = &e->dev->config;
+
+	if (!sched->millis) {
+		return 0;
+	}
+	return (now - e->op_ms) > BME280_SCHED_TIMEOUT_MS + BME280_MeasureTimeMax(cfg->osrs_t, cfg->osrs_p, cfg->osrs_h) / 1000;
+}
+
+/*!
+ *  @brief This internal API drops the operation of a faulty sensor and
+ *  frees its port for the other sensors: the port driver stops the hung
+ *  or failed transfer (sched->port_abort) before the driver forgets it.
+ *  The sensor is recovered after a backoff doubled per fault in a row,
+ *  and given up after BME280_SCHED_MAX_FAULTS.
+ */
+static void fault(const bme280_sched *sched, bme280_sched_entry *e, uint32_t now) {
+	uint32_t backoff = BME280_SCHED_BACKOFF_MAX_MS;
+
+	if (sched->port_abort) {
+		sched->port_abort(e->port);
+	}
+	BME280_Abort(e->port, e->dev);
+	e->owner = 0;
+	if (++e->faults >= BME280_SCHED_MAX_FAULTS) {
+		e->dead = 1;
+		return;
+	}
+	if (e->faults <= 16 && (BME280_SCHED_BACKOFF_MS << (e->faults - 1)) < BME280_SCHED_BACKOFF_MAX_MS) {
+		backoff = BME280_SCHED_BACKOFF_MS << (e->faults - 1);
+	}
+	e->retry_ms = now + backoff;
+	e->recover = 1;
+}
+
+static void sample_done(bme280_sched *sched, uint8_t idx) {
+	bme280_sched_entry *e = &sched->table[idx];
+	uint32_t now = 0;
+	uint32_t period;
+
+	e->faults = 0;
+
+	if (sched->millis && e->dev->config.mode == BME280_FORCED_MODE) {
+		now = sched->millis();
+		period = e->period_ms ? e->period_ms : BME280_SCHED_FORCED_MS;
+		e->due_ms = e->trigger_ms + period;
+		if ((int32_t)(now - e->due_ms) > 0) {//late, do not catch up
+			e->due_ms = now;
+		}
+	} else if (sched->millis) {
+		now = sched->millis();
+		period = (BME280_CyclePeriod(&e->dev->config) + 999) / 1000;
+		if (!e->dev->fresh) {//read ahead of the sensor, retry soon
+			e->due_ms = now + period / 8 + 1;
+		} else {
+			e->due_ms = now + period;
+		}
+	}
+	if (!e->dev->fresh) {
+		e->dups++;
+		return;
+	}
+	if (sched->millis) {
+		e->last_ms = now;
+		if (e->samples == 0) {
+			e->first_ms = e->last_ms;
+		}
+	}
+	e->samples++;
+	if (sched->on_sample) {
+		sched->on_sample(idx, e->dev);
+	}
+}
+
+/*!
+ *  @brief This API advances every sensor whose port is free. Call it from
+ *  the main loop or the port completion interrupt. A sensor keeps its port
+ *  from the first to the last step of an operation, when it finishes the
+ *  next sensor on the same port starts in the same run, so a port does not
+ *  wait for the next call while work is pending. The start entry rotates
+ *  for fairness. Normal mode sensors are read once per cycle period, a
+ *  duplicate frame moves the next read by 1/8 of the period. Forced mode
+ *  sensors are triggered once per period_ms and release the port during
+ *  the conversion, the status is read after dev->wait_us. A port error
+ *  or a hang of a sensor frees the port at once, the sensor is reset and
+ *  set up again after a backoff, see fault().
+ */
+void BME280_SchedRun(bme280_sched *sched) {
+	bme280_sched_entry *e;
+	uint32_t now = sched->millis ? sched->millis() : sched->runs;
+	uint8_t n;
+	uint8_t idx;
+	uint8_t done;
+	uint8_t owner;
+
+	for (n = 0; n < sched->count; n++) {
+		idx = (uint8_t)((sched->next + n) % sched->count);
+		e = &sched->table[idx];
+		if (e->dead) {
+			continue;
+		}
+		if (e->owner && (e->port->status == PORT_ERROR || timed_out(sched, e, now))) {
+			fault(sched, e, now);
+			continue;
+		}
+		if (e->recover && (int32_t)(now - e->retry_ms) < 0) {
+			continue;
+		}
+		if (e->port->status != PORT_FREE || port_taken(sched, idx) || waiting(sched, e, now)) {
+			continue;
+		}
+		if (e->recover && e->ready) {
+			if (BME280_Recover(e->port, e->dev)) {
+				e->recover = 0;
+			}
+		} else if (!e->ready) {
+			done = BME280_Init(e->port, e->dev);
+			if (done) {
+				e->recover = 0;
+				e->ready = (e->dev->status == OK);
+				e->dead = !e->ready;
+			}
+		} else if (e->dev->config.mode == BME280_FORCED_MODE) {
+			if (read_due(sched, e)) {
+				if (e->dev->step == 0) {
+					e->trigger_ms = now;
+				}
+				done = BME280_GetDataForced(e->port, e->dev);
+				if (done) {
+					sample_done(sched, idx);
+				}
+			}
+		} else if (read_due(sched, e)) {
+			done = BME280_GetData(e->port, e->dev);
+			if (done) {
+				sample_done(sched, idx);
+			}
+		}
+		if (e->dev->wait_us && sched->millis) {//port is free meanwhile
+			e->due_ms = now + e->dev->wait_us / 1000 + 1;
+		}
+		owner = (e->dev->step != 0 && !e->dev->wait_us);
+		if (owner && !e->owner) {
+			e->op_ms = now;
+		}
+		e->owner = owner;
+	}
+	sched->next = (uint8_t)((sched->next + 1) % sched->count);
+	sched->runs++;
+}
+
+/*!
+ *  @brief This API returns the effective fresh sample rate of a sensor in mHz,
+ *  measured from its first to its last new sample. 0 without a millis source.
+ */
+uint32_t BME280_SchedRate(const bme280_sched *sched, uint8_t idx) {
+	const bme280_sched_entry *e = &sched->table[idx];
+	uint32_t span;
+
+	if (!sched->millis || e->samples < 2) {
+		return 0;
+	}
+	span = e->last_ms - e->first_ms;
+	if (span == 0) {
+		return 0;
+	}
+	return (uint32_t)((uint64_t)(e->samples - 1) * 1000000UL / span);
+}
@@ -0,0 +1,83 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	BME280_Sched.h
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+#ifndef BME280_BME280_SCHED_H_
+#define BME280_BME280_SCHED_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "BME280.h"
+//===========================================================================================
+#define BME280_SCHED_TIMEOUT_MS		20		//operation time over the measurement time that is a hang
+#define BME280_SCHED_BACKOFF_MS		10		//retry delay after the first fault, doubled per fault
+#define BME280_SCHED_BACKOFF_MAX_MS	5000
+#define BME280_SCHED_MAX_FAULTS		16		//faults in a row before the sensor is given up, about 40 s
+#define BME280_SCHED_FORCED_MS		1000	//forced mode sample period of an entry with period_ms 0
+
+/*!
+ * @brief One sensor of the scheduler table, port, dev and period_ms are set
+ * by the application
+ */
+typedef struct bme280_sched_entry_t {
+		I2C_Connection *port;	// Bus the sensor is connected to
+		BME280_t *dev;			// Sensor, BME280_ADDR1 or BME280_ADDR2 on the port
+		uint32_t period_ms;		// Forced mode: time between triggers, 0 for BME280_SCHED_FORCED_MS
+		uint8_t owner;			// Entry holds its port until the current operation ends
+		uint8_t ready;			// Init done
+		uint8_t dead;			// Init failed or too many faults, entry is skipped
+		uint8_t recover;		// Fault seen, recovery starts at retry_ms
+		uint8_t faults;			// Faults in a row
+		uint32_t op_ms;			// Start of the current operation
+		uint32_t retry_ms;
+		uint32_t samples;		// New samples
+		uint32_t dups;			// Normal mode reads that returned the previous sample again
+		uint32_t due_ms;		// Next read, forced measurement or step after a driver wait not before this time
+		uint32_t trigger_ms;	// Forced mode: start of the current measurement
+		uint32_t first_ms;		// Time of the first sample
+		uint32_t last_ms;		// Time of the last sample
+} bme280_sched_entry;
+
+/*!
+ * @brief Scheduler for many sensors on one or more ports.
+ * on_sample is called for every new sample, duplicates are dropped.
+ * millis is optional: with it normal mode reads are paced by the
+ * sensor cycle period, forced measurements by period_ms, the port is
+ * free during the conversion time, hangs are detected and BME280_SchedRate
+ * works. Without it a waiting sensor is called again on every run.
+ */
+typedef struct bme280_sched_t {
+		bme280_sched_entry *table;
+		uint8_t count;
+		uint8_t next;			// Entry served first on the next run
+		uint32_t runs;			// Time of the fault backoff without millis
+		void (*on_sample)(uint8_t idx, BME280_t *dev);
+		uint32_t (*millis)(void);
+		void (*port_abort)(I2C_Connection *port);	// Optional, stops a hung transfer in the port driver, set after SchedInit
+} bme280_sched;
+
+void BME280_SchedInit(bme280_sched *sched, bme280_sched_entry *table, uint8_t count,
+		void (*on_sample)(uint8_t idx, BME280_t *dev), uint32_t (*millis)(void));
+void BME280_SchedRun(bme280_sched *sched);
+uint32_t BME280_SchedRate(const bme280_sched *sched, uint8_t idx);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* BME280_BME280_SCHED_H_ */
@@ -0,0 +1,128 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	bench.h
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+
+#ifndef BENCH_BENCH_H_
+#define BENCH_BENCH_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+//===========================================================================================
+#define BENCH_REPS	201		//timed repetitions, median and p99 are taken over these
+
+/* Cycle counter of the host: TSC on x86 (reference cycles, not core clocks
+ * under frequency scaling), the virtual counter on AArch64, else nanoseconds.
+ * On the target use the DWT cycle counter with the same reports. */
+#if defined(__x86_64__) || defined(__i386__)
+#define BENCH_CYCLE_UNIT	"cyc"
+static inline uint64_t bench_cycles(void) {
+	return __rdtsc();
+}
+#elif defined(__aarch64__)
+#define BENCH_CYCLE_UNIT	"tick"
+static inline uint64_t bench_cycles(void) {
+	uint64_t t;
+	__asm__ volatile("isb; mrs %0, cntvct_el0" : "=r"(t));
+	return t;
+}
+#else
+#define BENCH_CYCLE_UNIT	"ns"
+static inline uint64_t bench_cycles(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+static inline uint64_t bench_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/*!
+ * @brief Per sample cost of one benchmark, median and 99th percentile of the
+ * repetitions.
+ */
+typedef struct bench_result_t {
+		double cyc_med;
+		double cyc_p99;
+		double ns_med;
+		double ns_p99;
+} bench_result;
+
+static volatile uint32_t bench_sink;	//results are folded in here so calls are not optimised out
+#ifdef BENCH_SOFTFLOAT
+extern volatile uint32_t bench_float_calls;	//calls into the soft-float helpers, see bench_softfloat.c
+#endif
+
+static int bench_cmp(const void *a, const void *b) {
+	double x = *(const double *)a;
+	double y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+//sorted rep times in place, p in percent
+static inline double bench_percentile(double *t, uint32_t n, uint32_t p) {
+	qsort(t, n, sizeof(*t), bench_cmp);
+	return t[(n - 1) * p / 100];
+}
+
+/*!
+ * @brief Runs fn BENCH_REPS times after one warm-up call, fn processes
+ * samples samples per call.
+ */
+static inline bench_result bench_measure(void (*fn)(void *ctx), void *ctx, uint32_t samples) {
+	static double cyc[BENCH_REPS];
+	static double ns[BENCH_REPS];
+	bench_result r;
+	uint64_t c0, t0;
+	uint32_t i;
+
+	fn(ctx);
+	for (i = 0; i < BENCH_REPS; i++) {
+		t0 = bench_ns();
+		c0 = bench_cycles();
+		fn(ctx);
+		cyc[i] = (double)(bench_cycles() - c0) / samples;
+		ns[i] = (double)(bench_ns() - t0) / samples;
+	}
+	r.cyc_med = bench_percentile(cyc, BENCH_REPS, 50);
+	r.cyc_p99 = bench_percentile(cyc, BENCH_REPS, 99);
+	r.ns_med = bench_percentile(ns, BENCH_REPS, 50);
+	r.ns_p99 = bench_percentile(ns, BENCH_REPS, 99);
+	return r;
+}
+
+static inline void bench_header(const char *title) {
+	printf("\n%s\n%-34s %10s %10s %9s %9s %12s\n", title, "",
+			BENCH_CYCLE_UNIT " med", BENCH_CYCLE_UNIT " p99", "ns med", "ns p99", "samples/s");
+}
+
+static inline void bench_print(const char *name, const bench_result *r) {
+	printf("%-34s %10.1f %10.1f %9.1f %9.1f %12.0f\n", name, r->cyc_med, r->cyc_p99,
+			r->ns_med, r->ns_p99, r->ns_med > 0 ? 1e9 / r->ns_med : 0);
+}
+
+#endif /* BENCH_BENCH_H_ */
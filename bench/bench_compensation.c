@@ -0,0 +1,158 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	bench_compensation.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+
+#include "bench.h"
+#include "mock_bme280.h"
+#include <string.h>
+
+/* Cost per sample of every compensate_* function and of
+ * bme280_calculate_data_int/_float, for each calibration set of the chip
+ * model and two raw sweeps. With BENCH_SOFTFLOAT (soft-float target) the
+ * calls into the float helpers of libgcc are counted as well. */
+#define SAMPLES	1024
+
+static bme280_uncomp_data raw[SAMPLES];
+static int32_t t_fine[SAMPLES];		//of raw[i], taken by the pressure and humidity functions
+static BME280_t dev;
+
+typedef struct sweep_t {
+		const char *name;
+		uint32_t t_min, t_span;		// raw ranges
+		uint32_t p_min, p_span;
+		uint32_t h_min, h_span;
+} sweep;
+
+//raw ranges of the datasheet example calibration
+static const sweep sweeps[] = {
+	{"indoor 15..30 C, 950..1050 hPa", 500000, 40000, 390000, 40000, 20000, 20000},
+	{"full range -40..85 C, 300..1100 hPa", 380000, 300000, 200000, 450000, 0, 65535}
+};
+
+static void fill(const sweep *sw) {
+	uint32_t x = 12345;
+	uint32_t i;
+
+	for (i = 0; i < SAMPLES; i++) {
+		x = x * 1103515245u + 12345u;
+		raw[i].temperature = sw->t_min + (x >> 8) % sw->t_span;
+		raw[i].pressure = sw->p_min + (x >> 4) % sw->p_span;
+		raw[i].humidity = sw->h_min + (x >> 12) % sw->h_span;
+		dev.uncomp_data = raw[i];
+		compensate_temperature_int(&dev);
+		t_fine[i] = dev.calib_data.t_fine;
+	}
+}
+
+#define BENCH_COMP(fn, expr) \
+	static void run_##fn(void *ctx) { \
+		uint32_t i; \
+		(void)ctx; \
+		for (i = 0; i < SAMPLES; i++) { \
+			dev.uncomp_data = raw[i]; \
+			dev.calib_data.t_fine = t_fine[i]; \
+			bench_sink += (uint32_t)(expr); \
+		} \
+	}
+
+BENCH_COMP(compensate_temperature_int, compensate_temperature_int(&dev))
+BENCH_COMP(compensate_pressure_int, compensate_pressure_int(&dev))
+BENCH_COMP(compensate_pressure_int64, compensate_pressure_int64(&dev))
+BENCH_COMP(compensate_humidity_int, compensate_humidity_int(&dev))
+BENCH_COMP(bme280_calculate_data_int, (bme280_calculate_data_int(&dev), dev.data_int.pressure))
+#ifndef BME280_NO_FLOAT
+BENCH_COMP(compensate_temperature_float, compensate_temperature_float(&dev))
+BENCH_COMP(compensate_pressure_float, compensate_pressure_float(&dev))
+BENCH_COMP(compensate_humidity_float, compensate_humidity_float(&dev))
+BENCH_COMP(bme280_calculate_data_float, (bme280_calculate_data_float(&dev), dev.data_float.pressure))
+#endif
+
+typedef struct comp_t {
+		const char *name;
+		void (*run)(void *ctx);
+} comp;
+
+#define COMP(fn)	{#fn, run_##fn}
+//int and float twins at the same index, compared in the float / int line
+static const comp comp_int[] = {
+	COMP(compensate_temperature_int),
+	COMP(compensate_pressure_int),
+	COMP(compensate_humidity_int),
+	COMP(bme280_calculate_data_int),
+	COMP(compensate_pressure_int64)
+};
+#ifndef BME280_NO_FLOAT
+static const comp comp_float[] = {
+	COMP(compensate_temperature_float),
+	COMP(compensate_pressure_float),
+	COMP(compensate_humidity_float),
+	COMP(bme280_calculate_data_float)
+};
+#endif
+#define N_INT	(sizeof(comp_int) / sizeof(comp_int[0]))
+#define N_FLOAT	4
+
+static void report(const comp *c, bench_result *r) {
+	*r = bench_measure(c->run, 0, SAMPLES);
+	bench_print(c->name, r);
+#ifdef BENCH_SOFTFLOAT
+	{
+		uint32_t calls = bench_float_calls;
+
+		c->run(0);
+		printf("%-34s %10.1f float helper calls per sample\n", "",
+				(double)(bench_float_calls - calls) / SAMPLES);
+	}
+#endif
+}
+
+int main(void) {
+	static const char *const channel[N_FLOAT] = {"temperature", "pressure", "humidity", "calculate_data"};
+	bench_result ri[N_INT];
+	char title[96];
+	uint32_t s, w, i;
+
+	for (s = 0; s < sizeof(mock_calib_sets) / sizeof(mock_calib_sets[0]); s++) {
+		dev.calib_data = mock_calib_sets[s];
+		bme280_prepare_calib_data(&dev);
+		for (w = 0; w < sizeof(sweeps) / sizeof(sweeps[0]); w++) {
+			fill(&sweeps[w]);
+			snprintf(title, sizeof(title), "calibration set %u, %s", (unsigned)s, sweeps[w].name);
+			bench_header(title);
+			for (i = 0; i < N_INT; i++) {
+				report(&comp_int[i], &ri[i]);
+			}
+#ifndef BME280_NO_FLOAT
+			{
+				bench_result rf[N_FLOAT];
+
+				for (i = 0; i < N_FLOAT; i++) {
+					report(&comp_float[i], &rf[i]);
+				}
+				printf("float / int:");
+				for (i = 0; i < N_FLOAT; i++) {
+					printf(" %s %.2fx", channel[i], rf[i].ns_med / ri[i].ns_med);
+				}
+				printf("\n");
+			}
+#endif
+		}
+	}
+	return 0;
+}
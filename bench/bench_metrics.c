@@ -0,0 +1,97 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	bench_metrics.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+
+#include "bench.h"
+#include "BME280_Metrics.h"
+#include <math.h>
+
+/* Cycles per call of the fixed point metrics of BME280_Metrics.c next to
+ * the same formulas in float with libm (powf, logf, expf), the code every
+ * consumer of data_float ran before. */
+#define SAMPLES	1024
+
+static bme280_data_int in[SAMPLES];
+static int32_t altitude[SAMPLES];
+
+//data in the sensor range: 300..1100 hPa, -40..85 degC, 1..100 %RH
+static void sweep(void) {
+	uint32_t x = 4321;
+	uint32_t i;
+
+	for (i = 0; i < SAMPLES; i++) {
+		x = x * 1103515245u + 12345u;
+		in[i].pressure = 30000 + (x >> 4) % 80000;
+		in[i].temperature = -4000 + (int32_t)((x >> 8) % 12500);
+		in[i].humidity = 1024 + (x >> 12) % (99 * 1024);
+		altitude[i] = (int32_t)((x >> 6) % 900000);		//0..9 km in cm
+	}
+}
+
+#define BENCH_METRIC(name, expr) \
+	static void run_##name(void *ctx) { \
+		uint32_t i; \
+		(void)ctx; \
+		for (i = 0; i < SAMPLES; i++) { \
+			bench_sink += (uint32_t)(expr); \
+		} \
+	}
+
+BENCH_METRIC(altitude, BME280_Altitude(in[i].pressure, BME280_SEA_LEVEL_PRESSURE))
+BENCH_METRIC(sea_level, BME280_SeaLevelPressure(in[i].pressure, altitude[i]))
+BENCH_METRIC(dew_point, BME280_DewPoint(in[i].temperature, in[i].humidity))
+BENCH_METRIC(abs_humidity, BME280_AbsoluteHumidity(in[i].temperature, in[i].humidity))
+
+static float magnus_gamma(float t, float rh) {
+	return logf(rh / 100.0f) + 17.62f * t / (243.12f + t);
+}
+
+BENCH_METRIC(altitude_f, 4433000.0f * (1.0f - powf(in[i].pressure / 101325.0f, 0.190263f)))
+BENCH_METRIC(sea_level_f, in[i].pressure / powf(1.0f - altitude[i] / 4433000.0f, 5.25588f))
+BENCH_METRIC(dew_point_f, 100.0f * 243.12f * magnus_gamma(in[i].temperature / 100.0f, in[i].humidity / 1024.0f)
+		/ (17.62f - magnus_gamma(in[i].temperature / 100.0f, in[i].humidity / 1024.0f)))
+BENCH_METRIC(abs_humidity_f, 1000.0f * 216.74f * 6.112f * expf(17.62f * (in[i].temperature / 100.0f)
+		/ (243.12f + in[i].temperature / 100.0f)) * (in[i].humidity / 102400.0f)
+		/ (273.15f + in[i].temperature / 100.0f))
+
+int main(void) {
+	static const struct {
+		const char *name;
+		void (*run)(void *ctx);
+	} metrics[] = {
+		{"BME280_Altitude", run_altitude},
+		{"  float powf", run_altitude_f},
+		{"BME280_SeaLevelPressure", run_sea_level},
+		{"  float powf", run_sea_level_f},
+		{"BME280_DewPoint", run_dew_point},
+		{"  float logf", run_dew_point_f},
+		{"BME280_AbsoluteHumidity", run_abs_humidity},
+		{"  float expf", run_abs_humidity_f}
+	};
+	bench_result r;
+	uint32_t i;
+
+	sweep();
+	bench_header("derived metrics per call, fixed point and libm float");
+	for (i = 0; i < sizeof(metrics) / sizeof(metrics[0]); i++) {
+		r = bench_measure(metrics[i].run, 0, SAMPLES);
+		bench_print(metrics[i].name, &r);
+	}
+	return 0;
+}
@@ -0,0 +1,99 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	bench_modes.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+
+#include "bench.h"
+#include "mock_bme280.h"
+#include <string.h>
+
+/* Cost of the compensation of one sample by BME280_GetData for every
+ * BME280_OUTPUT mode, next to the two full passes GetData made before the
+ * output selection (bme280_calculate_data_int then _float, t_fine twice). */
+#define SAMPLES	1024
+
+static bme280_uncomp_data raw[SAMPLES];
+
+typedef struct mode_ctx_t {
+		BME280_t *dev;
+		uint8_t both_passes;
+} mode_ctx;
+
+//raw frames across the operating range, the same set for every mode
+static void sweep(void) {
+	uint32_t x = 12345;
+	uint32_t i;
+
+	for (i = 0; i < SAMPLES; i++) {
+		x = x * 1103515245u + 12345u;
+		raw[i].temperature = 420000 + (x >> 8) % 200000;
+		raw[i].pressure = 250000 + (x >> 4) % 200000;
+		raw[i].humidity = 15000 + (x >> 12) % 30000;
+	}
+}
+
+//what GetData does with a fresh frame
+static void run_mode(void *ctx) {
+	mode_ctx *c = ctx;
+	BME280_t *dev = c->dev;
+	uint32_t i;
+
+	for (i = 0; i < SAMPLES; i++) {
+		dev->uncomp_data = raw[i];
+		dev->dirty = BME280_DIRTY_ALL;
+		if (c->both_passes) {
+			bme280_calculate_data_int(dev);
+#ifndef BME280_NO_FLOAT
+			bme280_calculate_data_float(dev);
+#endif
+		} else {
+			bme280_calculate_data(dev);
+		}
+		bench_sink += dev->data_int.pressure + dev->uncomp_data.pressure;
+	}
+}
+
+int main(void) {
+	static const struct {
+		const char *name;
+		uint8_t output;
+		uint8_t both_passes;
+	} modes[] = {
+		{"int + float passes (before)", BME280_OUTPUT_BOTH, 1},
+		{"BME280_OUTPUT_BOTH", BME280_OUTPUT_BOTH, 0},
+		{"BME280_OUTPUT_INT", BME280_OUTPUT_INT, 0},
+		{"BME280_OUTPUT_FLOAT", BME280_OUTPUT_FLOAT, 0},
+		{"BME280_OUTPUT_RAW", BME280_OUTPUT_RAW, 0}
+	};
+	BME280_t dev = {.addr = BME280_ADDR1};
+	mode_ctx ctx = {&dev, 0};
+	bench_result r;
+	uint32_t i;
+
+	sweep();
+	dev.calib_data = mock_calib_sets[0];
+	bme280_prepare_calib_data(&dev);
+	bench_header("compensation per sample by output mode");
+	for (i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+		dev.output = modes[i].output;
+		ctx.both_passes = modes[i].both_passes;
+		r = bench_measure(run_mode, &ctx, SAMPLES);
+		bench_print(modes[i].name, &r);
+	}
+	return 0;
+}
@@ -0,0 +1,104 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	bench_profile.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+
+#include "bench.h"
+#include "mock_bme280.h"
+
+/* Compensation cost in the build profile of this executable, built once
+ * per profile for the profile_report target: the default and the
+ * integer-only BME280_NO_FLOAT. Same raw frames as bench_modes. */
+#define SAMPLES	1024
+
+#ifdef BME280_NO_FLOAT
+#define PROFILE	"BME280_NO_FLOAT"
+#else
+#define PROFILE	"default"
+#endif
+
+static bme280_uncomp_data raw[SAMPLES];
+
+static void sweep(void) {
+	uint32_t x = 12345;
+	uint32_t i;
+
+	for (i = 0; i < SAMPLES; i++) {
+		x = x * 1103515245u + 12345u;
+		raw[i].temperature = 420000 + (x >> 8) % 200000;
+		raw[i].pressure = 250000 + (x >> 4) % 200000;
+		raw[i].humidity = 15000 + (x >> 12) % 30000;
+	}
+}
+
+//what GetData does with a fresh frame
+static void run_calculate(void *ctx) {
+	BME280_t *dev = ctx;
+	uint32_t i;
+
+	for (i = 0; i < SAMPLES; i++) {
+		dev->uncomp_data = raw[i];
+		dev->dirty = BME280_DIRTY_ALL;
+		bme280_calculate_data(dev);
+		bench_sink += dev->data_int.pressure;
+	}
+}
+
+static void run_pressure_int(void *ctx) {
+	BME280_t *dev = ctx;
+	uint32_t i;
+
+	for (i = 0; i < SAMPLES; i++) {
+		dev->uncomp_data = raw[i];
+		dev->dirty = BME280_DIRTY_ALL;
+		bench_sink += BME280_GetPressureInt(dev);
+	}
+}
+
+static void run_pressure_int64(void *ctx) {
+	BME280_t *dev = ctx;
+	uint32_t i;
+
+	for (i = 0; i < SAMPLES; i++) {
+		dev->uncomp_data = raw[i];
+		dev->dirty = BME280_DIRTY_ALL;
+		bench_sink += BME280_GetPressureInt64(dev);
+	}
+}
+
+int main(void) {
+	BME280_t dev = {.addr = BME280_ADDR1};
+	bench_result r;
+
+	sweep();
+	dev.calib_data = mock_calib_sets[0];
+	bme280_prepare_calib_data(&dev);
+	printf("profile %s: sizeof(BME280_t) %u B\n", PROFILE, (unsigned)sizeof(BME280_t));
+	bench_header("compensation per sample, profile " PROFILE);
+	dev.output = BME280_OUTPUT_BOTH;
+	r = bench_measure(run_calculate, &dev, SAMPLES);
+	bench_print("calculate_data (default output)", &r);
+	dev.output = BME280_OUTPUT_INT;
+	r = bench_measure(run_calculate, &dev, SAMPLES);
+	bench_print("calculate_data BME280_OUTPUT_INT", &r);
+	r = bench_measure(run_pressure_int, &dev, SAMPLES);
+	bench_print("pressure int32", &r);
+	r = bench_measure(run_pressure_int64, &dev, SAMPLES);
+	bench_print("pressure int64 (Pa/256)", &r);
+	return 0;
+}
@@ -0,0 +1,70 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	bench_softfloat.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+
+#include <stdint.h>
+
+/* Counts the calls into the ARM EABI soft-float helpers of libgcc, linked
+ * with -Wl,--wrap=<helper> for every helper below (BME280_BENCH_SOFTFLOAT).
+ * Each call is the cost the float compensation adds on an FPU-less MCU. */
+volatile uint32_t bench_float_calls;
+
+#define WRAP1(name, ret, arg) \
+	ret __real_##name(arg a); \
+	ret __wrap_##name(arg a) { \
+		bench_float_calls++; \
+		return __real_##name(a); \
+	}
+#define WRAP2(name, ret, arg) \
+	ret __real_##name(arg a, arg b); \
+	ret __wrap_##name(arg a, arg b) { \
+		bench_float_calls++; \
+		return __real_##name(a, b); \
+	}
+
+WRAP2(__aeabi_fadd, float, float)
+WRAP2(__aeabi_fsub, float, float)
+WRAP2(__aeabi_frsub, float, float)
+WRAP2(__aeabi_fmul, float, float)
+WRAP2(__aeabi_fdiv, float, float)
+WRAP2(__aeabi_fcmplt, int, float)
+WRAP2(__aeabi_fcmple, int, float)
+WRAP2(__aeabi_fcmpgt, int, float)
+WRAP2(__aeabi_fcmpge, int, float)
+WRAP2(__aeabi_fcmpeq, int, float)
+WRAP1(__aeabi_f2iz, int32_t, float)
+WRAP1(__aeabi_f2uiz, uint32_t, float)
+WRAP1(__aeabi_i2f, float, int32_t)
+WRAP1(__aeabi_ui2f, float, uint32_t)
+WRAP1(__aeabi_f2d, double, float)
+WRAP1(__aeabi_d2f, float, double)
+WRAP2(__aeabi_dadd, double, double)
+WRAP2(__aeabi_dsub, double, double)
+WRAP2(__aeabi_drsub, double, double)
+WRAP2(__aeabi_dmul, double, double)
+WRAP2(__aeabi_ddiv, double, double)
+WRAP2(__aeabi_dcmplt, int, double)
+WRAP2(__aeabi_dcmple, int, double)
+WRAP2(__aeabi_dcmpgt, int, double)
+WRAP2(__aeabi_dcmpge, int, double)
+WRAP2(__aeabi_dcmpeq, int, double)
+WRAP1(__aeabi_d2iz, int32_t, double)
+WRAP1(__aeabi_d2uiz, uint32_t, double)
+WRAP1(__aeabi_i2d, double, int32_t)
+WRAP1(__aeabi_ui2d, double, uint32_t)
@@ -0,0 +1,65 @@
+# Writes the size and cycle report of the build profiles to OUT, run by the
+# profile_report target:
+#   PROFILES	profile names, OBJECTS_<profile> objects of the library, both
+#				separated by |, BENCH_<profile> bench_profile executable
+#   SIZE		size tool of the toolchain, EMULATOR to run target executables
+#   FLAGS		compile flags of the profiles
+
+string(REPLACE "|" ";" PROFILES "${PROFILES}")
+
+#appends val right aligned in width characters to the variable var
+function(report_column var val width)
+	string(LENGTH "${val}" len)
+	set(col "${val}")
+	while(len LESS width)
+		set(col " ${col}")
+		math(EXPR len "${len} + 1")
+	endwhile()
+	set(${var} "${${var}}${col}" PARENT_SCOPE)
+endfunction()
+
+set(report "BME280 build profiles, ${FLAGS}\n\n")
+string(APPEND report "profile      text B    data B     bss B  BME280.o text B\n")
+foreach(profile ${PROFILES})
+	string(REPLACE "|" ";" objects "${OBJECTS_${profile}}")
+	execute_process(COMMAND ${SIZE} ${objects} OUTPUT_VARIABLE out RESULT_VARIABLE res)
+	if(NOT res EQUAL 0)
+		message(FATAL_ERROR "${SIZE} failed on the ${profile} objects")
+	endif()
+	string(REPLACE "\n" ";" lines "${out}")
+	set(text 0)
+	set(data 0)
+	set(bss 0)
+	set(core 0)
+	foreach(line ${lines})
+		if(line MATCHES "^ *([0-9]+)[ \t]+([0-9]+)[ \t]+([0-9]+)[ \t]+[0-9]+[ \t]+[0-9a-f]+[ \t]+(.*)$")
+			set(obj_text ${CMAKE_MATCH_1})
+			math(EXPR text "${text} + ${CMAKE_MATCH_1}")
+			math(EXPR data "${data} + ${CMAKE_MATCH_2}")
+			math(EXPR bss "${bss} + ${CMAKE_MATCH_3}")
+			if(CMAKE_MATCH_4 MATCHES "/BME280\\.c\\.o(bj)?$")
+				set(core ${obj_text})
+			endif()
+		endif()
+	endforeach()
+	string(APPEND report "${profile}")
+	string(LENGTH "${profile}" len)
+	math(EXPR pad "19 - ${len}")
+	report_column(report "${text}" ${pad})
+	report_column(report "${data}" 10)
+	report_column(report "${bss}" 10)
+	report_column(report "${core}" 17)
+	string(APPEND report "\n")
+endforeach()
+
+foreach(profile ${PROFILES})
+	execute_process(COMMAND ${EMULATOR} ${BENCH_${profile}} OUTPUT_VARIABLE out RESULT_VARIABLE res)
+	if(NOT res EQUAL 0)
+		message(FATAL_ERROR "${BENCH_${profile}} failed")
+	endif()
+	string(APPEND report "\n${out}")
+endforeach()
+
+file(WRITE ${OUT} "${report}")
+message("${report}")
+message("Written to ${OUT}")
@@ -0,0 +1,49 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	check.h
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+#ifndef TESTS_CHECK_H_
+#define TESTS_CHECK_H_
+
+#include <stdio.h>
+//===========================================================================================
+static int check_failures;
+
+#define CHECK(cond) do { \
+		if (!(cond)) { \
+			printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+			check_failures++; \
+		} \
+	} while (0)
+
+#define CHECK_EQ(a, b) do { \
+		long long check_a_ = (long long)(a); \
+		long long check_b_ = (long long)(b); \
+		if (check_a_ != check_b_) { \
+			printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, check_a_, check_b_); \
+			check_failures++; \
+		} \
+	} while (0)
+
+//exit code of the test executable
+static inline int check_result(const char *name) {
+	printf("%s: %s\n", name, check_failures ? "FAILED" : "passed");
+	return check_failures ? 1 : 0;
+}
+
+#endif /* TESTS_CHECK_H_ */
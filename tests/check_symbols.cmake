@@ -0,0 +1,25 @@
+# Fails if the binary BIN has one of the FORBIDDEN symbols or misses one of
+# the REQUIRED ones (lists separated by |), NM is the nm of the toolchain.
+
+string(REPLACE "|" ";" FORBIDDEN "${FORBIDDEN}")
+string(REPLACE "|" ";" REQUIRED "${REQUIRED}")
+execute_process(COMMAND ${NM} ${BIN} OUTPUT_VARIABLE out RESULT_VARIABLE res)
+if(NOT res EQUAL 0)
+	message(FATAL_ERROR "${NM} failed on ${BIN}")
+endif()
+set(failed 0)
+foreach(sym ${FORBIDDEN})
+	if(out MATCHES "[ \t]_?${sym}\n")
+		message(SEND_ERROR "${sym} is linked")
+		set(failed 1)
+	endif()
+endforeach()
+foreach(sym ${REQUIRED})
+	if(NOT out MATCHES "[ \t]_?${sym}\n")
+		message(SEND_ERROR "${sym} is missing, the check does not see the symbols")
+		set(failed 1)
+	endif()
+endforeach()
+if(NOT failed)
+	message("symbols ok")
+endif()
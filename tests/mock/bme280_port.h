@@ -0,0 +1,78 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	bme280_port.h
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+#ifndef BME280_PORT_H_
+#define BME280_PORT_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Host replacement of "main.h" and "I2C/MyI2C.h" selected with
+ * BME280_PORT_HEADER. The port keeps the contract of the STM32 driver:
+ * I2C_Start_IRQ sets PORT_BUSY, the completion interrupt (mock_bus_irq)
+ * runs the transfer and sets PORT_FREE or PORT_ERROR. */
+#include <stdint.h>
+
+typedef enum {
+	OK		= 0x00,
+	INIT	= 0x01,
+	FAULTH	= 0x02
+} Device_status_t;
+
+typedef enum {
+	PORT_FREE	= 0x00,
+	PORT_BUSY	= 0x01,
+	PORT_DONE	= 0x02,
+	PORT_ERROR	= 0x03
+} PortStatus_t;
+
+typedef enum {
+	I2C_MODE_READ	= 0x00,
+	I2C_MODE_WRITE	= 0x01
+} I2C_Mode_t;
+
+#define MOCK_FIFO_LEN	256
+
+typedef struct fifo_t {
+		uint8_t buf[MOCK_FIFO_LEN];
+		uint16_t head;
+		uint16_t tail;
+} fifo_t;
+
+struct mock_bus_t;
+
+typedef struct I2C_Connection_t {
+		uint8_t addr;
+		uint8_t reg;
+		uint8_t len;
+		I2C_Mode_t mode;
+		volatile PortStatus_t status;
+		fifo_t buffer;
+		struct mock_bus_t *bus;		// Simulated peripheral, see mock_port.h
+} I2C_Connection;
+
+void PutOne(fifo_t *f, uint8_t val);
+void PutMulti(fifo_t *f, const uint8_t *val, uint16_t len);
+void GetMulti(fifo_t *f, uint8_t *val, uint16_t len);
+void I2C_Start_IRQ(I2C_Connection *port);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* BME280_PORT_H_ */
@@ -0,0 +1,198 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	mock_bme280.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+#include "mock_bme280.h"
+#include "mock_port.h"
+#include <string.h>
+
+/* Set 0 is the example of the BMP280/BME280 datasheets with typical humidity
+ * coefficients, sets 1 and 2 are coefficients in the range of production parts. */
+const bme280_calib_data mock_calib_sets[3] = {
+	{27504, 26435, -1000, 36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000,
+			75, 362, 0, 313, 50, 30, 0},
+	{28245, 26711, 50, 37688, -10544, 3024, 7416, -55, -7, 9900, -10230, 4285,
+			75, 368, 0, 296, 50, 30, 0},
+	{27915, 26294, 50, 36606, -10644, 3024, 6284, 24, -7, 12300, -7800, 4285,
+			75, 352, 0, 320, 0, 30, 0}
+};
+
+static inline uint8_t elapsed(uint32_t t) {
+	return (int32_t)(mock_time_us - t) >= 0;
+}
+
+static uint32_t count(uint8_t osrs) {
+	static const uint8_t cnt[8] = {0, 1, 2, 4, 8, 16, 16, 16};
+	return cnt[osrs & 0x07];
+}
+
+//typical measurement time of the oversampling in ctrl_hum and ctrl_meas, datasheet section 9.1
+static uint32_t measure_time(const mock_bme280 *chip) {
+	uint32_t t = count(chip->regs[BME280_REG_CTRL_MEAS_PWR] >> 5);
+	uint32_t p = count(chip->regs[BME280_REG_CTRL_MEAS_PWR] >> 2);
+	uint32_t h = count(chip->regs[BME280_REG_CTRL_HUM]);
+
+	return 1000 + 2000 * t + (p ? 2000 * p + 500 : 0) + (h ? 2000 * h + 500 : 0);
+}
+
+static uint32_t standby_time(const mock_bme280 *chip) {
+	static const uint32_t time[8] = {500, 62500, 125000, 250000, 500000, 1000000, 10000, 20000};
+	return time[chip->regs[BME280_REG_CFG] >> 5];
+}
+
+static void put16(uint8_t *dt, uint16_t val) {
+	dt[0] = (uint8_t)val;
+	dt[1] = (uint8_t)(val >> 8);
+}
+
+//data registers 0xF7..0xFE of the raw value
+static void latch(mock_bme280 *chip) {
+	uint8_t *dt = &chip->regs[BME280_REG_DATA];
+
+	dt[0] = (uint8_t)(chip->raw.pressure >> 12);
+	dt[1] = (uint8_t)(chip->raw.pressure >> 4);
+	dt[2] = (uint8_t)(chip->raw.pressure << 4);
+	dt[3] = (uint8_t)(chip->raw.temperature >> 12);
+	dt[4] = (uint8_t)(chip->raw.temperature >> 4);
+	dt[5] = (uint8_t)(chip->raw.temperature << 4);
+	dt[6] = (uint8_t)(chip->raw.humidity >> 8);
+	dt[7] = (uint8_t)chip->raw.humidity;
+	chip->raw.pressure += chip->step.pressure;
+	chip->raw.temperature += chip->step.temperature;
+	chip->raw.humidity += chip->step.humidity;
+	chip->measurements++;
+}
+
+static void start(mock_bme280 *chip, uint32_t at) {
+	chip->measuring = 1;
+	chip->meas_end_us = at + measure_time(chip);
+}
+
+/*!
+ *  @brief Loads the calibration into the register map, the chip starts in
+ *  sleep mode with the NVM copy done. raw is the datasheet example.
+ */
+void mock_bme280_init(mock_bme280 *chip, uint8_t addr, const bme280_calib_data *calib) {
+	uint8_t *dt = chip->regs;
+
+	memset(chip, 0, sizeof(*chip));
+	chip->addr = addr;
+	put16(&dt[0x88], calib->dig_t1);
+	put16(&dt[0x8A], (uint16_t)calib->dig_t2);
+	put16(&dt[0x8C], (uint16_t)calib->dig_t3);
+	put16(&dt[0x8E], calib->dig_p1);
+	put16(&dt[0x90], (uint16_t)calib->dig_p2);
+	put16(&dt[0x92], (uint16_t)calib->dig_p3);
+	put16(&dt[0x94], (uint16_t)calib->dig_p4);
+	put16(&dt[0x96], (uint16_t)calib->dig_p5);
+	put16(&dt[0x98], (uint16_t)calib->dig_p6);
+	put16(&dt[0x9A], (uint16_t)calib->dig_p7);
+	put16(&dt[0x9C], (uint16_t)calib->dig_p8);
+	put16(&dt[0x9E], (uint16_t)calib->dig_p9);
+	dt[0xA1] = calib->dig_h1;
+	dt[BME280_REG_CHIP_ID] = BME280_CHIP_ID;
+	put16(&dt[0xE1], (uint16_t)calib->dig_h2);
+	dt[0xE3] = calib->dig_h3;
+	dt[0xE4] = (uint8_t)(calib->dig_h4 >> 4);
+	dt[0xE5] = (uint8_t)((calib->dig_h4 & 0x0F) | ((calib->dig_h5 & 0x0F) << 4));
+	dt[0xE6] = (uint8_t)(calib->dig_h5 >> 4);
+	dt[0xE7] = (uint8_t)calib->dig_h6;
+	dt[BME280_REG_DATA] = 0x80;	//reset value of the data registers
+	dt[BME280_REG_DATA + 3] = 0x80;
+	dt[BME280_REG_DATA + 6] = 0x80;
+	chip->raw.pressure = 415148;
+	chip->raw.temperature = 519888;
+	chip->raw.humidity = 27000;
+	chip->nack_until_us = mock_time_us;
+	chip->nvm_until_us = mock_time_us;
+}
+
+/*!
+ *  @brief Advances the measurements to the mock time.
+ */
+void mock_bme280_update(mock_bme280 *chip) {
+	for (;;) {
+		if (chip->measuring) {
+			if (!elapsed(chip->meas_end_us)) {
+				return;
+			}
+			latch(chip);
+			chip->measuring = 0;
+			if ((chip->regs[BME280_REG_CTRL_MEAS_PWR] & BME280_NORMAL_MODE) != BME280_NORMAL_MODE) {
+				chip->regs[BME280_REG_CTRL_MEAS_PWR] &= (uint8_t)~BME280_NORMAL_MODE;	//forced: back to sleep
+			}
+		}
+		if ((chip->regs[BME280_REG_CTRL_MEAS_PWR] & BME280_NORMAL_MODE) != BME280_NORMAL_MODE
+				|| !elapsed(chip->next_cycle_us)) {
+			return;
+		}
+		start(chip, chip->next_cycle_us);
+		chip->next_cycle_us += measure_time(chip) + standby_time(chip);
+	}
+}
+
+//the chip answers its address: not in the start-up after reset
+uint8_t mock_bme280_ack(mock_bme280 *chip) {
+	return elapsed(chip->nack_until_us);
+}
+
+uint8_t mock_bme280_read(mock_bme280 *chip, uint8_t reg) {
+	mock_bme280_update(chip);
+	if (reg == BME280_REG_STATUS) {
+		return (uint8_t)((chip->measuring ? BME280_STATUS_IS_MEASURE : 0)
+				| (elapsed(chip->nvm_until_us) ? 0 : BME280_STATUS_IM_UPDATE));
+	}
+	return chip->regs[reg];
+}
+
+void mock_bme280_write(mock_bme280 *chip, uint8_t reg, uint8_t val) {
+	mock_bme280_update(chip);
+	if (chip->wlog_len < MOCK_WLOG_LEN) {
+		chip->wlog[chip->wlog_len][0] = reg;
+		chip->wlog[chip->wlog_len][1] = val;
+		chip->wlog_len++;
+	}
+	switch (reg) {
+	case BME280_REG_RESET:
+		if (val == BME280_RESET_COMMAND) {
+			chip->regs[BME280_REG_CTRL_HUM] = 0;
+			chip->regs[BME280_REG_CTRL_MEAS_PWR] = 0;
+			chip->regs[BME280_REG_CFG] = 0;
+			chip->measuring = 0;
+			chip->nack_until_us = mock_time_us + MOCK_STARTUP_US;
+			chip->nvm_until_us = chip->nack_until_us + MOCK_NVM_COPY_US;
+			chip->resets++;
+		}
+		break;
+	case BME280_REG_CTRL_HUM:
+	case BME280_REG_CFG:
+		chip->regs[reg] = val;
+		break;
+	case BME280_REG_CTRL_MEAS_PWR:
+		chip->regs[reg] = val;
+		if ((val & BME280_NORMAL_MODE) == BME280_NORMAL_MODE) {
+			chip->next_cycle_us = mock_time_us;
+			mock_bme280_update(chip);
+		} else if ((val & BME280_NORMAL_MODE) && !chip->measuring) {
+			start(chip, mock_time_us);
+		}
+		break;
+	default:	//read only
+		break;
+	}
+}
@@ -0,0 +1,66 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	mock_bme280.h
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+#ifndef MOCK_BME280_H_
+#define MOCK_BME280_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "BME280.h"
+//===========================================================================================
+#define MOCK_STARTUP_US		2000	//power on or soft reset: the chip does not answer
+#define MOCK_NVM_COPY_US	300		//then status im_update is set
+#define MOCK_WLOG_LEN		16
+
+/*!
+ * @brief Register map model of one chip. Calibration at 0x88/0xE1, chip id,
+ * reset, ctrl_hum, status, ctrl_meas, config and the data at 0xF7.
+ * Forced and normal mode measurements take the typical measurement time of
+ * the oversampling set, the data registers are latched at the end of a
+ * measurement. Time is the mock clock of mock_port.h.
+ */
+typedef struct mock_bme280_t {
+		uint8_t addr;			// BME280_ADDR1 or BME280_ADDR2, answers on this address
+		uint8_t regs[256];
+		uint8_t measuring;		// Conversion running, ends at meas_end_us
+		uint32_t meas_end_us;
+		uint32_t next_cycle_us;	// Normal mode: start of the next measurement
+		uint32_t nack_until_us;	// Start-up after reset
+		uint32_t nvm_until_us;	// NVM copy after start-up
+		bme280_uncomp_data raw;	// Value of the next measurement
+		bme280_uncomp_data step;	// Added to raw after every measurement, 0 repeats the frame
+		uint32_t measurements;
+		uint32_t resets;
+		uint8_t wlog[MOCK_WLOG_LEN][2];	// Register writes in bus order: register, value
+		uint8_t wlog_len;
+} mock_bme280;
+
+extern const bme280_calib_data mock_calib_sets[3];
+
+void mock_bme280_init(mock_bme280 *chip, uint8_t addr, const bme280_calib_data *calib);
+void mock_bme280_update(mock_bme280 *chip);
+uint8_t mock_bme280_ack(mock_bme280 *chip);
+uint8_t mock_bme280_read(mock_bme280 *chip, uint8_t reg);
+void mock_bme280_write(mock_bme280 *chip, uint8_t reg, uint8_t val);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* MOCK_BME280_H_ */
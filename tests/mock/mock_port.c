@@ -0,0 +1,244 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	mock_port.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+#include "mock_port.h"
+#include <string.h>
+
+#define MOCK_I2C_BYTE_US	23		//400 kHz, 9 clocks per byte
+#define MOCK_SPI_BYTE_US	1		//10 MHz
+#define MOCK_IDLE_US		100		//time of a step that started no transfer
+
+uint32_t mock_time_us;
+
+//FIFO	========================================================================
+void PutOne(fifo_t *f, uint8_t val) {
+	f->buf[f->head++ % MOCK_FIFO_LEN] = val;
+}
+
+void PutMulti(fifo_t *f, const uint8_t *val, uint16_t len) {
+	while (len--) {
+		PutOne(f, *val++);
+	}
+}
+
+static uint8_t GetOne(fifo_t *f) {
+	return f->buf[f->tail++ % MOCK_FIFO_LEN];
+}
+
+void GetMulti(fifo_t *f, uint8_t *val, uint16_t len) {
+	while (len--) {
+		*val++ = GetOne(f);
+	}
+}
+//PORT	========================================================================
+static void start(mock_bus *bus, I2C_Connection *port) {
+	bus->transfers++;
+	if (port->status != PORT_FREE || bus->pending || bus->hung) {
+		bus->misuse++;
+	}
+	port->status = PORT_BUSY;
+	if (bus->hang_next) {
+		bus->hang_next--;
+		bus->hung = port;
+		return;
+	}
+	bus->pending = port;
+	if (bus->sync) {
+		mock_bus_irq(bus);
+	}
+}
+
+void I2C_Start_IRQ(I2C_Connection *port) {
+	start(port->bus, port);
+}
+
+static void transport_start(void *ctx, I2C_Connection *port) {
+	start((mock_bus *)ctx, port);
+}
+
+/*!
+ *  @brief Connects the simulated peripheral to a port, type BME280_BUS_I2C
+ *  for I2C_Start_IRQ or an SPI type for mock_bus_transport.
+ */
+void mock_bus_init(mock_bus *bus, I2C_Connection *port, uint8_t type) {
+	memset(bus, 0, sizeof(*bus));
+	memset(port, 0, sizeof(*port));
+	bus->type = type;
+	port->status = PORT_FREE;
+	port->bus = bus;
+}
+
+void mock_bus_attach(mock_bus *bus, mock_bme280 *chip) {
+	uint8_t i;
+
+	for (i = 0; i < MOCK_BUS_CHIPS; i++) {
+		if (!bus->chip[i]) {
+			bus->chip[i] = chip;
+			return;
+		}
+	}
+}
+
+bme280_transport mock_bus_transport(mock_bus *bus) {
+	bme280_transport tr = {bus->type, transport_start, bus};
+	return tr;
+}
+
+static mock_bme280 *select_chip(mock_bus *bus, const I2C_Connection *port) {
+	uint8_t i;
+
+	if (bus->type != BME280_BUS_I2C) {
+		return bus->chip[0];
+	}
+	for (i = 0; i < MOCK_BUS_CHIPS; i++) {
+		if (bus->chip[i] && bus->chip[i]->addr == port->addr) {
+			return bus->chip[i];
+		}
+	}
+	return 0;
+}
+
+//register of an SPI control byte, bit 7 must be set for reads and cleared for writes
+static uint8_t spi_reg(mock_bus *bus, uint8_t ctrl, uint8_t read) {
+	if (((ctrl & BME280_SPI_READ) != 0) != read) {
+		bus->spi_rw_errors++;
+	}
+	return (uint8_t)(ctrl | BME280_SPI_READ);
+}
+
+static void run(mock_bus *bus, I2C_Connection *port, mock_bme280 *chip) {
+	uint8_t spi = (bus->type != BME280_BUS_I2C);
+	uint8_t reg;
+	uint8_t i;
+
+	if (port->mode == I2C_MODE_READ) {
+		bus->reads++;
+		reg = spi ? spi_reg(bus, port->reg, 1) : port->reg;
+		if (reg == BME280_REG_STATUS) {
+			bus->status_reads++;
+		}
+		if (bus->type == BME280_BUS_SPI3 && !(chip->regs[BME280_REG_CFG] & BME280_SPI_3WIRE_MODE_ON)) {
+			//the chip drives SDO, not the shared data line: the host reads a floating line
+			bus->spi3w_errors++;
+			for (i = 0; i < port->len; i++) {
+				PutOne(&port->buffer, 0xFF);
+			}
+			return;
+		}
+		for (i = 0; i < port->len; i++) {
+			PutOne(&port->buffer, mock_bme280_read(chip, (uint8_t)(reg + i)));
+		}
+		return;
+	}
+	//write: data of reg, then register address/data pairs
+	bus->writes++;
+	reg = spi ? spi_reg(bus, port->reg, 0) : port->reg;
+	mock_bme280_write(chip, reg, GetOne(&port->buffer));
+	for (i = 1; i + 1 < port->len; i += 2) {
+		reg = GetOne(&port->buffer);
+		reg = spi ? spi_reg(bus, reg, 0) : reg;
+		mock_bme280_write(chip, reg, GetOne(&port->buffer));
+	}
+	if (i < port->len) {
+		GetOne(&port->buffer);
+	}
+}
+
+/*!
+ *  @brief Completion interrupt: runs the pending transfer, advances the
+ *  mock time by the bus time and sets PORT_FREE, or PORT_ERROR on a NACK
+ *  or an injected error, then calls bus->irq. Returns 0 if no transfer is
+ *  pending (idle or hung).
+ */
+uint8_t mock_bus_irq(mock_bus *bus) {
+	I2C_Connection *port = bus->pending;
+	mock_bme280 *chip;
+
+	if (!port) {
+		return 0;
+	}
+	bus->pending = 0;
+	mock_time_us += (uint32_t)(port->len + 2) * (bus->type == BME280_BUS_I2C ? MOCK_I2C_BYTE_US : MOCK_SPI_BYTE_US);
+	chip = select_chip(bus, port);
+	if (bus->fail_next || !chip || !mock_bme280_ack(chip)) {
+		if (bus->fail_next) {
+			bus->fail_next--;
+		}
+		if (port->mode == I2C_MODE_WRITE) {
+			port->buffer.tail = port->buffer.head;	//drop the unsent bytes
+		}
+		bus->errors++;
+		port->status = PORT_ERROR;
+	} else {
+		run(bus, port, chip);
+		port->status = PORT_FREE;
+	}
+	if (bus->irq) {
+		bus->irq(bus->irq_ctx);
+	}
+	return 1;
+}
+
+/*!
+ *  @brief Aborts a running or hung transfer of the port like a peripheral
+ *  reset, the port is left PORT_ERROR. A transfer started while a hung one
+ *  was not aborted counts as misuse, even if the driver set PORT_FREE.
+ */
+void mock_bus_abort(I2C_Connection *port) {
+	mock_bus *bus = port->bus;
+
+	if (port->status == PORT_BUSY || bus->hung == port) {
+		bus->aborts++;
+		bus->pending = 0;
+		bus->hung = 0;
+		port->buffer.tail = port->buffer.head;
+		port->status = PORT_ERROR;
+	}
+}
+
+void mock_advance(uint32_t us) {
+	mock_time_us += us;
+}
+
+uint32_t mock_millis(void) {
+	return mock_time_us / 1000;
+}
+
+/*!
+ *  @brief Runs a step function of the driver until it returns 1, completing
+ *  every transfer it starts and sleeping dev->wait_us after a wait step. Returns the number of calls, 0 if it did not
+ *  end in max_calls or a transfer hung.
+ */
+uint32_t mock_run(I2C_Connection *port, BME280_t *dev,
+		uint8_t (*op)(I2C_Connection *_i2c, BME280_t *dev), uint32_t max_calls) {
+	uint32_t calls;
+
+	for (calls = 1; calls <= max_calls; calls++) {
+		if (op(port, dev)) {
+			return calls;
+		}
+		if (!mock_bus_irq(port->bus)) {
+			if (port->status == PORT_BUSY) {
+				return 0;
+			}
+			mock_advance(dev->wait_us ? dev->wait_us : MOCK_IDLE_US);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,73 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	mock_port.h
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+#ifndef MOCK_PORT_H_
+#define MOCK_PORT_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "BME280.h"
+#include "mock_bme280.h"
+//===========================================================================================
+#define MOCK_BUS_CHIPS	2
+
+/*!
+ * @brief Simulated peripheral behind one I2C_Connection. A transfer started
+ * with I2C_Start_IRQ (or the transport of mock_bus_transport) leaves the
+ * port PORT_BUSY until mock_bus_irq runs it against the chips, like the
+ * completion interrupt of the STM32 driver.
+ */
+typedef struct mock_bus_t {
+		uint8_t type;			// BME280_BUS
+		mock_bme280 *chip[MOCK_BUS_CHIPS];	// I2C: selected by address, SPI: chip[0]
+		I2C_Connection *pending;	// Transfer started, not completed yet
+		I2C_Connection *hung;		// Transfer that never completes until mock_bus_abort
+		void (*irq)(void *ctx);	// Completion interrupt handler of the application
+		void *irq_ctx;
+		uint8_t fail_next;		// Next transfers end with PORT_ERROR
+		uint8_t hang_next;		// Next transfers never complete
+		uint8_t sync;			// Transfers complete inside the start call, irq included
+		uint32_t transfers;
+		uint32_t reads;
+		uint32_t writes;
+		uint32_t status_reads;	// Reads of BME280_REG_STATUS
+		uint32_t errors;		// Transfers ended with PORT_ERROR
+		uint32_t aborts;		// Hung transfers dropped by mock_bus_abort
+		uint32_t misuse;		// Transfers started on a busy port
+		uint32_t spi_rw_errors;	// SPI control bytes with a wrong bit 7
+		uint32_t spi3w_errors;	// 3-wire reads while spi3w_en is clear, the data is 0xFF
+} mock_bus;
+
+extern uint32_t mock_time_us;
+
+void mock_bus_init(mock_bus *bus, I2C_Connection *port, uint8_t type);
+void mock_bus_attach(mock_bus *bus, mock_bme280 *chip);
+bme280_transport mock_bus_transport(mock_bus *bus);
+uint8_t mock_bus_irq(mock_bus *bus);
+void mock_bus_abort(I2C_Connection *port);
+void mock_advance(uint32_t us);
+uint32_t mock_millis(void);
+uint32_t mock_run(I2C_Connection *port, BME280_t *dev,
+		uint8_t (*op)(I2C_Connection *_i2c, BME280_t *dev), uint32_t max_calls);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* MOCK_PORT_H_ */
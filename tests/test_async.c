@@ -0,0 +1,199 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	test_async.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+
+#include "check.h"
+#include "mock_port.h"
+#include "BME280_Async.h"
+#include <stddef.h>
+
+/* Event driven operation on the simulated port: the completion interrupt
+ * of the bus calls BME280_AsyncIRQ, a one-shot timer BME280_AsyncTimer. */
+static I2C_Connection port;
+static mock_bus bus;
+static mock_bme280 chip;
+static BME280_t dev = {.addr = BME280_ADDR1};
+static bme280_async as;
+static uint32_t timer_us;	// Armed timer, 0 when stopped
+static uint32_t timer_starts;
+static uint32_t done_calls;
+
+static void port_irq(void *ctx) {
+	BME280_AsyncIRQ(ctx);
+}
+
+static void start_timer(bme280_async *a, uint32_t us) {
+	CHECK(a == &as);
+	CHECK(timer_us == 0);
+	CHECK_EQ(port.status, PORT_FREE);
+	timer_us = us;
+	timer_starts++;
+}
+
+static void done(BME280_t *d, void *ctx) {
+	CHECK(d == &dev);
+	CHECK(ctx == &done_calls);
+	done_calls++;
+}
+
+//interrupts in time order until the operation ends, like the main loop sleeping
+static void run(void) {
+	uint32_t us;
+
+	while (as.op) {
+		if (mock_bus_irq(&bus)) {
+			continue;
+		}
+		if (!timer_us) {
+			CHECK(timer_us);	//stalled: no transfer and no timer
+			return;
+		}
+		us = timer_us;
+		timer_us = 0;
+		mock_advance(us);
+		BME280_AsyncTimer(&as);
+	}
+}
+
+static void setup(void) {
+	done_calls = 0;
+	timer_starts = 0;
+	timer_us = 0;
+	mock_bus_init(&bus, &port, BME280_BUS_I2C);
+	mock_bme280_init(&chip, BME280_ADDR1, &mock_calib_sets[0]);
+	mock_bus_attach(&bus, &chip);
+	bus.irq = port_irq;
+	bus.irq_ctx = &as;
+	as.port = &port;
+	as.dev = &dev;
+	as.start_timer = start_timer;
+	CHECK(BME280_InitAsync(&as, done, &done_calls));
+	run();
+	CHECK_EQ(done_calls, 1);
+	CHECK_EQ(dev.status, OK);
+	CHECK_EQ(timer_starts, 0);
+	done_calls = 0;
+}
+
+//forced mode: trigger, then nothing until the timer of the conversion time
+static void test_forced(void) {
+	setup();
+	dev.config.mode = BME280_FORCED_MODE;
+	bus.transfers = 0;
+	bus.status_reads = 0;
+	CHECK(BME280_GetDataAsync(&as, done, &done_calls));
+	CHECK(mock_bus_irq(&bus));	//trigger written
+	CHECK_EQ(timer_us, BME280_MeasureTimeMax(dev.config.osrs_t, dev.config.osrs_p, dev.config.osrs_h));
+	CHECK_EQ(port.status, PORT_FREE);
+	CHECK_EQ(bus.transfers, 1);
+	CHECK(!mock_bus_irq(&bus));	//idle during the conversion
+	run();
+	CHECK_EQ(done_calls, 1);
+	CHECK_EQ(dev.error, BME280_ERR_NONE);
+	CHECK(dev.fresh);
+	CHECK_EQ(timer_starts, 1);
+	CHECK_EQ(bus.status_reads, 1);
+	CHECK_EQ(bus.transfers, 3);
+	CHECK_EQ(chip.measurements, 1);
+	CHECK_EQ(bus.misuse, 0);
+}
+
+//a conversion still running is polled again from the timer
+static void test_forced_poll(void) {
+	setup();
+	dev.config.mode = BME280_FORCED_MODE;
+	CHECK(BME280_GetDataAsync(&as, done, &done_calls));
+	CHECK(mock_bus_irq(&bus));
+	timer_us = 0;
+	mock_advance(100);	//timer fired too early
+	BME280_AsyncTimer(&as);
+	run();
+	CHECK_EQ(done_calls, 1);
+	CHECK(timer_starts >= 2);
+	CHECK_EQ(chip.measurements, 1);
+}
+
+//without a timer the wait cannot end: the operation is dropped, the sensor stays set up
+static void test_no_timer(void) {
+	setup();
+	dev.config.mode = BME280_FORCED_MODE;
+	as.start_timer = NULL;
+	CHECK(BME280_GetDataAsync(&as, done, &done_calls));
+	CHECK(mock_bus_irq(&bus));
+	CHECK_EQ(done_calls, 1);
+	CHECK_EQ(dev.error, BME280_ERR_CONFIG);
+	CHECK_EQ(dev.status, OK);
+	CHECK_EQ(dev.step, 0);
+	CHECK(as.op == NULL);
+}
+
+//reset start-up of BME280_Recover through the timer
+static void test_recover(void) {
+	setup();
+	CHECK(BME280_AsyncStart(&as, BME280_Recover, done, &done_calls));
+	run();
+	CHECK_EQ(done_calls, 1);
+	CHECK_EQ(dev.status, OK);
+	CHECK_EQ(chip.resets, 1);
+	CHECK_EQ(timer_starts, 1);
+	CHECK_EQ(bus.errors, 0);
+}
+
+//transfers completing inside their start: the steps go on in the loop, op is not entered twice
+static void test_sync(void) {
+	setup();
+	bus.sync = 1;
+	dev.status = INIT;
+	CHECK(BME280_InitAsync(&as, done, &done_calls));
+	CHECK_EQ(done_calls, 1);
+	CHECK_EQ(dev.status, OK);
+	CHECK(as.op == NULL);
+	CHECK(BME280_GetDataAsync(&as, done, &done_calls));
+	run();
+	CHECK_EQ(done_calls, 2);
+	CHECK_EQ(dev.data_int.temperature, 2508);
+	dev.config.mode = BME280_FORCED_MODE;
+	timer_starts = 0;
+	chip.measurements = 0;
+	CHECK(BME280_GetDataAsync(&as, done, &done_calls));
+	CHECK_EQ(timer_starts, 1);
+	run();
+	CHECK_EQ(chip.measurements, 1);
+	CHECK_EQ(done_calls, 3);
+	CHECK_EQ(dev.error, BME280_ERR_NONE);
+	CHECK(dev.fresh);
+	bus.fail_next = 1;
+	CHECK(BME280_GetDataAsync(&as, done, &done_calls));
+	CHECK_EQ(done_calls, 4);
+	CHECK_EQ(dev.error, BME280_ERR_BUS);
+	CHECK_EQ(timer_starts, 1);
+	CHECK_EQ(port.status, PORT_FREE);
+	CHECK(as.op == NULL);
+	CHECK_EQ(as.running, 0);
+	CHECK_EQ(bus.misuse, 0);
+}
+
+int main(void) {
+	test_forced();
+	test_forced_poll();
+	test_no_timer();
+	test_recover();
+	test_sync();
+	return check_result("test_async");
+}
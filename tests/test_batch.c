@@ -0,0 +1,106 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	test_batch.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+
+#include "check.h"
+#include "mock_port.h"
+#include <string.h>
+
+#define LEN	150		//not a multiple of BME280_BATCH_BLOCK
+
+static uint32_t raw_t[LEN];
+static uint32_t raw_p[LEN];
+static uint32_t raw_h[LEN];
+static BME280_t devs[3];
+static const BME280_t *dev_of[LEN];
+
+static void setup(void) {
+	uint32_t x = 1;
+	uint32_t i;
+
+	for (i = 0; i < 3; i++) {
+		devs[i].calib_data = mock_calib_sets[i];
+		bme280_prepare_calib_data(&devs[i]);
+	}
+	for (i = 0; i < LEN; i++) {
+		x = x * 1103515245u + 12345u;
+		raw_t[i] = 420000 + (x >> 8) % 200000;
+		raw_p[i] = 250000 + (x >> 4) % 200000;
+		raw_h[i] = 15000 + (x >> 12) % 30000;
+		dev_of[i] = &devs[i % 3];
+	}
+}
+
+//single sample compensation of BME280_GetData
+static void reference(const BME280_t *src, uint32_t i, BME280_t *dev) {
+	memcpy(dev, src, sizeof(*dev));
+	dev->output = BME280_OUTPUT_BOTH;
+	dev->uncomp_data.temperature = raw_t[i];
+	dev->uncomp_data.pressure = raw_p[i];
+	dev->uncomp_data.humidity = raw_h[i];
+	bme280_calculate_data(dev);
+}
+
+static void test_shared_dev(void) {
+	static int32_t t[LEN];
+	static uint32_t p[LEN];
+	static uint32_t h[LEN];
+	static float tf[LEN];
+	static float pf[LEN];
+	static float hf[LEN];
+	const BME280_t *one = &devs[1];
+	BME280_t ref;
+	uint32_t i;
+
+	bme280_compensate_batch_int(&one, 0, raw_t, raw_p, raw_h, t, p, h, LEN);
+	bme280_compensate_batch_float(&one, 0, raw_t, raw_p, raw_h, tf, pf, hf, LEN);
+	for (i = 0; i < LEN; i++) {
+		reference(one, i, &ref);
+		CHECK_EQ(t[i], ref.data_int.temperature);
+		CHECK_EQ(p[i], ref.data_int.pressure);
+		CHECK_EQ(h[i], ref.data_int.humidity);
+		CHECK(tf[i] == ref.data_float.temperature);
+		CHECK(pf[i] == ref.data_float.pressure);
+		CHECK(hf[i] == ref.data_float.humidity);
+	}
+}
+
+static void test_per_sample_dev(void) {
+	static int32_t t[LEN];
+	static uint32_t h[LEN];
+	static float pf[LEN];
+	BME280_t ref;
+	uint32_t i;
+
+	bme280_compensate_batch_int(dev_of, 1, raw_t, raw_p, raw_h, t, 0, h, LEN);
+	bme280_compensate_batch_float(dev_of, 1, raw_t, raw_p, raw_h, 0, pf, 0, LEN);
+	for (i = 0; i < LEN; i++) {
+		reference(dev_of[i], i, &ref);
+		CHECK_EQ(t[i], ref.data_int.temperature);
+		CHECK_EQ(h[i], ref.data_int.humidity);
+		CHECK(pf[i] == ref.data_float.pressure);
+	}
+}
+
+int main(void) {
+	setup();
+	test_shared_dev();
+	test_per_sample_dev();
+	return check_result("test_batch");
+}
@@ -0,0 +1,313 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	test_compensation.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+
+#include "check.h"
+#include "mock_bme280.h"
+#include <math.h>
+#include <string.h>
+
+/* Fuzz of the compensation over random raw values and random calibrations
+ * in the range of production parts. The integer functions with prepared
+ * coefficients must match the Bosch integer formulas on the raw
+ * coefficients bit for bit, every function is compared with the Bosch
+ * double formulas and its max and mean error reported, the batch API must
+ * match the single sample functions. */
+#define CALIBS	64
+#define SAMPLES	2048
+
+static uint32_t rnd_state = 2026;
+
+static uint32_t rnd(void) {
+	rnd_state = rnd_state * 1103515245u + 12345u;
+	return rnd_state >> 8;
+}
+
+static int32_t rnd_range(int32_t min, int32_t max) {
+	return min + (int32_t)(rnd() % (uint32_t)(max - min + 1));
+}
+
+//coefficients around the ones of the datasheet and of the mock sets
+static void random_calib(bme280_calib_data *cd) {
+	memset(cd, 0, sizeof(*cd));
+	cd->dig_t1 = (uint16_t)rnd_range(27000, 29500);
+	cd->dig_t2 = (int16_t)rnd_range(25500, 27500);
+	cd->dig_t3 = (int16_t)rnd_range(-1000, 100);
+	cd->dig_p1 = (uint16_t)rnd_range(35500, 38500);
+	cd->dig_p2 = (int16_t)rnd_range(-10900, -10300);
+	cd->dig_p3 = (int16_t)rnd_range(2900, 3200);
+	cd->dig_p4 = (int16_t)rnd_range(2000, 8500);
+	cd->dig_p5 = (int16_t)rnd_range(-200, 200);
+	cd->dig_p6 = (int16_t)rnd_range(-7, -7);
+	cd->dig_p7 = (int16_t)rnd_range(9000, 16000);
+	cd->dig_p8 = (int16_t)rnd_range(-15000, -7000);
+	cd->dig_p9 = (int16_t)rnd_range(4000, 6500);
+	cd->dig_h1 = (uint8_t)rnd_range(0, 100);
+	cd->dig_h2 = (int16_t)rnd_range(340, 380);
+	cd->dig_h3 = 0;
+	cd->dig_h4 = (int16_t)rnd_range(280, 340);
+	cd->dig_h5 = (int16_t)rnd_range(0, 50);
+	cd->dig_h6 = 30;
+}
+
+//raw values over the sensor range, a few outside
+static void random_raw(bme280_uncomp_data *raw) {
+	raw->temperature = (uint32_t)rnd_range(380000, 680000);
+	raw->pressure = (uint32_t)rnd_range(200000, 650000);
+	raw->humidity = (uint32_t)rnd_range(0, 65535);
+}
+
+//REFERENCE	=====================================================================
+//Bosch BME280 driver, integer formulas on the raw coefficients
+static int32_t ref_t_fine(const bme280_calib_data *cd, uint32_t adc_t) {
+	int32_t var1 = (int32_t)((adc_t / 8) - ((int32_t)cd->dig_t1 * 2));
+	int32_t var2 = (int32_t)((adc_t / 16) - ((int32_t)cd->dig_t1));
+
+	var1 = (var1 * ((int32_t)cd->dig_t2)) / 2048;
+	var2 = (((var2 * var2) / 4096) * ((int32_t)cd->dig_t3)) / 16384;
+	return var1 + var2;
+}
+
+static uint32_t ref_pressure_int(const bme280_calib_data *cd, int32_t t_fine, uint32_t adc_p) {
+	int32_t var1, var2, var3, var4;
+	uint32_t var5, p;
+
+	var1 = (t_fine / 2) - (int32_t)64000;
+	var2 = (((var1 / 4) * (var1 / 4)) / 2048) * ((int32_t)cd->dig_p6);
+	var2 = var2 + ((var1 * ((int32_t)cd->dig_p5)) * 2);
+	var2 = (var2 / 4) + (((int32_t)cd->dig_p4) * 65536);
+	var3 = (cd->dig_p3 * (((var1 / 4) * (var1 / 4)) / 8192)) / 8;
+	var4 = (((int32_t)cd->dig_p2) * var1) / 2;
+	var1 = (var3 + var4) / 262144;
+	var1 = (((32768 + var1)) * ((int32_t)cd->dig_p1)) / 32768;
+	if (!var1) {
+		return 30000;
+	}
+	var5 = (uint32_t)((uint32_t)1048576) - adc_p;
+	p = ((uint32_t)(var5 - (uint32_t)(var2 / 4096))) * 3125;
+	p = (p < 0x80000000) ? (p << 1) / ((uint32_t)var1) : (p / (uint32_t)var1) * 2;
+	var1 = (((int32_t)cd->dig_p9) * ((int32_t)(((p / 8) * (p / 8)) / 8192))) / 4096;
+	var2 = (((int32_t)(p / 4)) * ((int32_t)cd->dig_p8)) / 8192;
+	p = (uint32_t)((int32_t)p + ((var1 + var2 + cd->dig_p7) / 16));
+	return p < 30000 ? 30000 : (p > 110000 ? 110000 : p);
+}
+
+static uint32_t ref_pressure_int64(const bme280_calib_data *cd, int32_t t_fine, uint32_t adc_p) {
+	int64_t var1, var2, p;
+
+	var1 = ((int64_t)t_fine) - 128000;
+	var2 = var1 * var1 * (int64_t)cd->dig_p6;
+	var2 = var2 + ((var1 * (int64_t)cd->dig_p5) * 131072);
+	var2 = var2 + (((int64_t)cd->dig_p4) * 34359738368);
+	var1 = ((var1 * var1 * (int64_t)cd->dig_p3) / 256) + ((var1 * ((int64_t)cd->dig_p2) * 4096));
+	var1 = ((((int64_t)1) * 140737488355328) + var1) * ((int64_t)cd->dig_p1) / 8589934592;
+	if (!var1) {
+		return 30000 * 256;
+	}
+	p = 1048576 - (int64_t)adc_p;
+	p = (((p * 2147483648) - var2) * 3125) / var1;
+	var1 = (((int64_t)cd->dig_p9) * (p / 8192) * (p / 8192)) / 33554432;
+	var2 = (((int64_t)cd->dig_p8) * p) / 524288;
+	p = ((p + var1 + var2) / 256) + (((int64_t)cd->dig_p7) * 16);
+	return (uint32_t)(p < 30000 * 256 ? 30000 * 256 : (p > 110000 * 256 ? 110000 * 256 : p));
+}
+
+static uint32_t ref_humidity_int(const bme280_calib_data *cd, int32_t t_fine, uint32_t adc_h) {
+	int32_t var1, var2, var3, var4, var5;
+
+	var1 = t_fine - ((int32_t)76800);
+	var2 = (int32_t)(adc_h * 16384);
+	var3 = (int32_t)(((int32_t)cd->dig_h4) * 1048576);
+	var4 = ((int32_t)cd->dig_h5) * var1;
+	var5 = (((var2 - var3) - var4) + (int32_t)16384) / 32768;
+	var2 = (var1 * ((int32_t)cd->dig_h6)) / 1024;
+	var3 = (var1 * ((int32_t)cd->dig_h3)) / 2048;
+	var4 = ((var2 * (var3 + (int32_t)32768)) / 1024) + (int32_t)2097152;
+	var2 = ((var4 * ((int32_t)cd->dig_h2)) + 8192) / 16384;
+	var3 = var5 * var2;
+	var4 = ((var3 / 32768) * (var3 / 32768)) / 128;
+	var5 = var3 - ((var4 * ((int32_t)cd->dig_h1)) / 16);
+	var5 = (var5 < 0 ? 0 : var5);
+	var5 = (var5 > 419430400 ? 419430400 : var5);
+	return (uint32_t)(var5 / 4096) > 102400 ? 102400 : (uint32_t)(var5 / 4096);
+}
+
+//Bosch double formulas, the exact values: degC, Pa, %RH
+typedef struct exact_t {
+		double temperature;
+		double pressure;
+		double humidity;
+} exact;
+
+static exact ref_double(const bme280_calib_data *cd, const bme280_uncomp_data *raw) {
+	double var1, var2, var3, var4, var5, var6, t_fine, p, h;
+	exact e;
+
+	var1 = ((double)raw->temperature) / 16384.0 - ((double)cd->dig_t1) / 1024.0;
+	var1 = var1 * ((double)cd->dig_t2);
+	var2 = (((double)raw->temperature) / 131072.0 - ((double)cd->dig_t1) / 8192.0);
+	var2 = (var2 * var2) * ((double)cd->dig_t3);
+	t_fine = var1 + var2;
+	e.temperature = fmin(fmax(t_fine / 5120.0, -40.0), 85.0);
+
+	var1 = (t_fine / 2.0) - 64000.0;
+	var2 = var1 * var1 * ((double)cd->dig_p6) / 32768.0;
+	var2 = var2 + var1 * ((double)cd->dig_p5) * 2.0;
+	var2 = (var2 / 4.0) + (((double)cd->dig_p4) * 65536.0);
+	var3 = ((double)cd->dig_p3) * var1 * var1 / 524288.0;
+	var1 = (var3 + ((double)cd->dig_p2) * var1) / 524288.0;
+	var1 = (1.0 + var1 / 32768.0) * ((double)cd->dig_p1);
+	p = 1048576.0 - (double)raw->pressure;
+	p = (p - (var2 / 4096.0)) * 6250.0 / var1;
+	var1 = ((double)cd->dig_p9) * p * p / 2147483648.0;
+	var2 = p * ((double)cd->dig_p8) / 32768.0;
+	p = p + (var1 + var2 + ((double)cd->dig_p7)) / 16.0;
+	e.pressure = fmin(fmax(p, 30000.0), 110000.0);
+
+	var1 = t_fine - 76800.0;
+	var2 = (((double)cd->dig_h4) * 64.0 + (((double)cd->dig_h5) / 16384.0) * var1);
+	var3 = raw->humidity - var2;
+	var4 = ((double)cd->dig_h2) / 65536.0;
+	var5 = (1.0 + (((double)cd->dig_h3) / 67108864.0) * var1);
+	var6 = 1.0 + (((double)cd->dig_h6) / 67108864.0) * var1 * var5;
+	var6 = var3 * var4 * (var5 * var6);
+	h = var6 * (1.0 - ((double)cd->dig_h1) * var6 / 524288.0);
+	e.humidity = fmin(fmax(h, 0.0), 100.0);
+	return e;
+}
+
+//ERROR	=========================================================================
+typedef struct err_t {
+		const char *name;
+		const char *unit;
+		double bound;		// Max error allowed
+		double max;
+		double sum;
+		uint32_t n;
+} err;
+
+enum {E_T_INT, E_T_FLOAT, E_P_INT, E_P_INT64, E_P_FLOAT, E_H_INT, E_H_FLOAT, E_COUNT};
+
+/* Bounds over the fuzz range, a bit above the errors seen: the integer
+ * formulas of the datasheet resolve 0.01 degC, 1 Pa (32 bit) and 1/1024 %RH
+ * and truncate inside, all paths share the integer t_fine (one LSB is
+ * about 0.0002 degC and up to 0.4 Pa at low pressure), the float path
+ * computes in float. */
+static err errs[E_COUNT] = {
+	{"compensate_temperature_int", "degC", 0.02, 0, 0, 0},
+	{"compensate_temperature_float", "degC", 0.003, 0, 0, 0},
+	{"compensate_pressure_int", "Pa", 8.0, 0, 0, 0},
+	{"compensate_pressure_int64", "Pa", 0.6, 0, 0, 0},
+	{"compensate_pressure_float", "Pa", 0.6, 0, 0, 0},
+	{"compensate_humidity_int", "%RH", 0.01, 0, 0, 0},
+	{"compensate_humidity_float", "%RH", 0.001, 0, 0, 0}
+};
+
+static void add(uint8_t idx, double value, double exact_value) {
+	double d = fabs(value - exact_value);
+
+	errs[idx].max = d > errs[idx].max ? d : errs[idx].max;
+	errs[idx].sum += d;
+	errs[idx].n++;
+}
+
+static void test_fuzz(void) {
+	static bme280_uncomp_data raw[SAMPLES];
+	static uint32_t raw_t[SAMPLES], raw_p[SAMPLES], raw_h[SAMPLES];
+	static int32_t bt[SAMPLES];
+	static uint32_t bp[SAMPLES], bh[SAMPLES];
+	static float btf[SAMPLES], bpf[SAMPLES], bhf[SAMPLES];
+	BME280_t dev = {.addr = BME280_ADDR1};
+	const BME280_t *one = &dev;
+	uint32_t mismatch = 0;
+	uint32_t batch_mismatch = 0;
+	uint32_t c, i;
+	int32_t t_fine;
+	exact e;
+	int32_t t;
+	uint32_t p, p64, h;
+	float tf, pf, hf;
+
+	for (c = 0; c < CALIBS; c++) {
+		if (c < 3) {
+			dev.calib_data = mock_calib_sets[c];
+		} else {
+			random_calib(&dev.calib_data);
+		}
+		bme280_prepare_calib_data(&dev);
+		for (i = 0; i < SAMPLES; i++) {
+			random_raw(&raw[i]);
+			raw_t[i] = raw[i].temperature;
+			raw_p[i] = raw[i].pressure;
+			raw_h[i] = raw[i].humidity;
+		}
+		bme280_compensate_batch_int(&one, 0, raw_t, raw_p, raw_h, bt, bp, bh, SAMPLES);
+		bme280_compensate_batch_float(&one, 0, raw_t, raw_p, raw_h, btf, bpf, bhf, SAMPLES);
+		for (i = 0; i < SAMPLES; i++) {
+			dev.uncomp_data = raw[i];
+			t = compensate_temperature_int(&dev);
+			t_fine = dev.calib_data.t_fine;
+			p = compensate_pressure_int(&dev);
+			p64 = compensate_pressure_int64(&dev);
+			h = compensate_humidity_int(&dev);
+			tf = compensate_temperature_float(&dev);
+			pf = compensate_pressure_float(&dev);
+			hf = compensate_humidity_float(&dev);
+			//prepared coefficients: bit exact to the formulas on the raw coefficients
+			if (t_fine != ref_t_fine(&dev.calib_data, raw[i].temperature)
+					|| p != ref_pressure_int(&dev.calib_data, t_fine, raw[i].pressure)
+					|| p64 != ref_pressure_int64(&dev.calib_data, t_fine, raw[i].pressure)
+					|| h != ref_humidity_int(&dev.calib_data, t_fine, raw[i].humidity)) {
+				mismatch++;
+			}
+			//calculate_data and the batch API give the same values
+			dev.dirty = BME280_DIRTY_ALL;
+			bme280_calculate_data_int(&dev);
+			bme280_calculate_data_float(&dev);
+			if (dev.data_int.temperature != t || dev.data_int.pressure != p || dev.data_int.humidity != h
+					|| dev.data_float.temperature != tf || dev.data_float.pressure != pf
+					|| dev.data_float.humidity != hf || bt[i] != t || bp[i] != p || bh[i] != h
+					|| btf[i] != tf || bpf[i] != pf || bhf[i] != hf) {
+				batch_mismatch++;
+			}
+			e = ref_double(&dev.calib_data, &raw[i]);
+			add(E_T_INT, t / 100.0, e.temperature);
+			add(E_T_FLOAT, tf, e.temperature);
+			add(E_P_INT, p, e.pressure);
+			add(E_P_INT64, p64 / 256.0, e.pressure);
+			add(E_P_FLOAT, pf, e.pressure);
+			add(E_H_INT, h / 1024.0, e.humidity);
+			add(E_H_FLOAT, hf, e.humidity);
+		}
+	}
+	CHECK_EQ(mismatch, 0);
+	CHECK_EQ(batch_mismatch, 0);
+	printf("%u calibrations x %u raw samples against the Bosch double formulas\n", CALIBS, SAMPLES);
+	printf("%-30s %12s %12s %10s\n", "", "max error", "mean error", "bound");
+	for (i = 0; i < E_COUNT; i++) {
+		printf("%-30s %12.6f %12.6f %10.4f %s\n", errs[i].name, errs[i].max, errs[i].sum / errs[i].n,
+				errs[i].bound, errs[i].unit);
+		CHECK(errs[i].max <= errs[i].bound);
+	}
+}
+
+int main(void) {
+	test_fuzz();
+	return check_result("test_compensation");
+}
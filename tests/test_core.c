@@ -0,0 +1,58 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	test_core.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+
+#include "check.h"
+#include "mock_port.h"
+
+/* Built from BME280.c and the simulated port only: the driver core links
+ * without the optional modules (log, record, scheduler, filter...). */
+static I2C_Connection port;
+static mock_bus bus;
+static mock_bme280 chip;
+static uint32_t raw_calls;
+static bme280_uncomp_data last_raw;
+
+static void on_raw(void *ctx, const bme280_uncomp_data *raw) {
+	CHECK(ctx == &raw_calls);
+	raw_calls++;
+	last_raw = *raw;
+}
+
+static void test_raw_hook(void) {
+	BME280_t dev = {.addr = BME280_ADDR1};
+
+	mock_bus_init(&bus, &port, BME280_BUS_I2C);
+	mock_bme280_init(&chip, BME280_ADDR1, &mock_calib_sets[0]);
+	mock_bus_attach(&bus, &chip);
+	CHECK(mock_run(&port, &dev, BME280_Init, 100));
+	dev.on_raw = on_raw;
+	dev.raw_ctx = &raw_calls;
+	mock_advance(200000);
+	CHECK(mock_run(&port, &dev, BME280_GetData, 10));
+	CHECK_EQ(raw_calls, 1);
+	CHECK_EQ(last_raw.temperature, 519888);
+	CHECK(mock_run(&port, &dev, BME280_GetData, 10));	//same frame, no new sample
+	CHECK_EQ(raw_calls, 1);
+}
+
+int main(void) {
+	test_raw_hook();
+	return check_result("test_core");
+}
@@ -0,0 +1,320 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	test_driver.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+#include "check.h"
+#include "mock_port.h"
+#include "BME280_Log.h"
+#include "BME280_Record.h"
+#include <stddef.h>
+#include <string.h>
+
+static I2C_Connection port;
+static mock_bus bus;
+static mock_bme280 chip;
+
+static void setup(void) {
+	mock_bus_init(&bus, &port, BME280_BUS_I2C);
+	mock_bme280_init(&chip, BME280_ADDR1, &mock_calib_sets[0]);
+	mock_bus_attach(&bus, &chip);
+}
+
+//step functions only run on a free port, one transfer at a time
+static void test_port_state(void) {
+	BME280_t dev = {.addr = BME280_ADDR1};
+
+	setup();
+	CHECK_EQ(BME280_Init(&port, &dev), 0);
+	CHECK_EQ(port.status, PORT_BUSY);
+	CHECK_EQ(BME280_Init(&port, &dev), 0);
+	CHECK_EQ(bus.transfers, 1);
+	CHECK(mock_bus_irq(&bus));
+	CHECK_EQ(port.status, PORT_FREE);
+	CHECK(mock_run(&port, &dev, BME280_Init, 100));
+	CHECK_EQ(bus.misuse, 0);
+}
+
+//power on: status polled while the NVM copy runs, calibration read, setup written
+static void test_init(void) {
+	BME280_t dev = {.addr = BME280_ADDR1};
+
+	setup();
+	chip.nvm_until_us = mock_time_us + 1000;
+	CHECK(mock_run(&port, &dev, BME280_Init, 100));
+	CHECK_EQ(dev.status, OK);
+	CHECK_EQ(dev.error, BME280_ERR_NONE);
+	CHECK(bus.status_reads > 1);
+	CHECK(memcmp(&dev.calib_data, &mock_calib_sets[0], offsetof(bme280_calib_data, t_fine)) == 0);
+	CHECK_EQ(chip.regs[BME280_REG_CTRL_HUM], BME280_HUM_OVERSAMPLING_16X);
+	CHECK_EQ(chip.regs[BME280_REG_CTRL_MEAS_PWR], BME280_TEMP_OVERSAMPLING_16X | BME280_PRESS_OVERSAMPLING_16X | BME280_NORMAL_MODE);
+	CHECK_EQ(chip.regs[BME280_REG_CFG], BME280_FILTER_COEFF_16 | BME280_STANDBY_TIME_20_MS);
+	CHECK_EQ(bus.errors, 0);
+}
+
+static void test_chip_id(void) {
+	BME280_t dev = {.addr = BME280_ADDR1};
+
+	setup();
+	chip.regs[BME280_REG_CHIP_ID] = 0x58;	//BMP280
+	CHECK(mock_run(&port, &dev, BME280_Init, 100));
+	CHECK_EQ(dev.error, BME280_ERR_CHIP_ID);
+	CHECK(dev.status != OK);
+}
+
+static void test_no_chip(void) {
+	BME280_t dev = {.addr = BME280_ADDR2};
+
+	setup();
+	BME280_Init(&port, &dev);
+	mock_bus_irq(&bus);
+	CHECK_EQ(port.status, PORT_ERROR);
+	CHECK_EQ(bus.errors, 1);
+}
+
+//normal mode: one burst read of 0xF7 per sample, datasheet example values
+static void test_normal_read(void) {
+	BME280_t dev = {.addr = BME280_ADDR1};
+	uint32_t transfers;
+
+	setup();
+	CHECK(mock_run(&port, &dev, BME280_Init, 100));
+	mock_advance(BME280_CyclePeriod(&dev.config));
+	transfers = bus.transfers;
+	CHECK(mock_run(&port, &dev, BME280_GetData, 10));
+	CHECK_EQ(bus.transfers - transfers, 1);
+	CHECK(dev.fresh);
+	CHECK_EQ(dev.uncomp_data.temperature, 519888);
+	CHECK_EQ(dev.uncomp_data.pressure, 415148);
+	CHECK_EQ(dev.data_int.temperature, 2508);
+	CHECK(dev.data_int.pressure > 100600 && dev.data_int.pressure < 100700);
+}
+
+//a restored calibration skips the calibration reads
+static void test_calib_cache(void) {
+	BME280_t dev = {.addr = BME280_ADDR1};
+	BME280_t cached = {.addr = BME280_ADDR1};
+	uint8_t blob[BME280_CALIB_BLOB_LEN];
+	uint32_t transfers;
+
+	setup();
+	CHECK(mock_run(&port, &dev, BME280_Init, 100));
+	BME280_SaveCalib(&dev, blob);
+	CHECK(BME280_RestoreCalib(&cached, blob));
+	transfers = bus.transfers;
+	CHECK(mock_run(&port, &cached, BME280_Init, 100));
+	CHECK_EQ(bus.transfers - transfers, 2);
+	CHECK_EQ(cached.status, OK);
+	CHECK(mock_run(&port, &cached, BME280_VerifyCalib, 100));
+	CHECK_EQ(cached.error, BME280_ERR_NONE);
+	blob[5] ^= 1;
+	CHECK_EQ(BME280_RestoreCalib(&cached, blob), 0);
+}
+
+//a changed calibration is taken whole, a wrong chip id leaves the one in use
+static void test_calib_verify(void) {
+	BME280_t dev = {.addr = BME280_ADDR1};
+	BME280_t ref = {.addr = BME280_ADDR1};
+	bme280_calib_data saved;
+	bme280_calib_prep saved_prep;
+	uint8_t blob[BME280_CALIB_BLOB_LEN];
+
+	setup();
+	CHECK(mock_run(&port, &dev, BME280_Init, 100));
+	BME280_SaveCalib(&dev, blob);
+	CHECK(BME280_RestoreCalib(&dev, blob));
+	chip.regs[BME280_REG_T_P_CALIB_DATA + 2] ^= 0x04;	//dig_t2
+	chip.regs[BME280_REG_HUM_CALIB_DATA + 1] ^= 0x01;	//dig_h2
+	saved = dev.calib_data;
+	saved_prep = dev.calib_prep;
+	chip.regs[BME280_REG_CHIP_ID] = 0x58;
+	CHECK(mock_run(&port, &dev, BME280_VerifyCalib, 100));
+	CHECK_EQ(dev.error, BME280_ERR_CHIP_ID);
+	CHECK(memcmp(&dev.calib_data, &saved, sizeof(dev.calib_data)) == 0);
+	CHECK(memcmp(&dev.calib_prep, &saved_prep, sizeof(dev.calib_prep)) == 0);
+	CHECK(dev.calib_cached);
+	chip.regs[BME280_REG_CHIP_ID] = BME280_CHIP_ID;
+	CHECK(mock_run(&port, &dev, BME280_VerifyCalib, 100));
+	CHECK_EQ(dev.error, BME280_ERR_CALIB);
+	CHECK_EQ(dev.calib_cached, 0);
+	CHECK(mock_run(&port, &ref, BME280_Init, 100));
+	CHECK(memcmp(&dev.calib_data, &ref.calib_data, offsetof(bme280_calib_data, t_fine)) == 0);
+	CHECK(memcmp(&dev.calib_prep, &ref.calib_prep, sizeof(dev.calib_prep)) == 0);
+	CHECK(dev.calib_data.dig_t2 != saved.dig_t2);
+	CHECK(dev.calib_data.dig_h2 != saved.dig_h2);
+	CHECK(mock_run(&port, &dev, BME280_VerifyCalib, 100));
+	CHECK_EQ(dev.error, BME280_ERR_NONE);
+}
+
+//forced mode: one measurement per call, the chip goes back to sleep
+static void test_forced(void) {
+	BME280_t dev = {.addr = BME280_ADDR1};
+
+	setup();
+	BME280_SetProfile(&dev, BME280_PROFILE_WEATHER);
+	CHECK(mock_run(&port, &dev, BME280_Init, 100));
+	CHECK_EQ(chip.regs[BME280_REG_CTRL_MEAS_PWR] & BME280_NORMAL_MODE, BME280_SLEEP_MODE);
+	CHECK(mock_run(&port, &dev, BME280_GetDataForced, 200));
+	CHECK_EQ(chip.measurements, 1);
+	CHECK(dev.fresh);
+	CHECK_EQ(dev.data_int.temperature, 2508);
+	CHECK_EQ(chip.regs[BME280_REG_CTRL_MEAS_PWR] & BME280_NORMAL_MODE, BME280_SLEEP_MODE);
+	//the same values again are a new measurement, not a duplicate
+	dev.dirty = 0;
+	CHECK(mock_run(&port, &dev, BME280_GetDataForced, 200));
+	CHECK_EQ(chip.measurements, 2);
+	CHECK(dev.fresh);
+	CHECK_EQ(dev.fresh_samples, 2);
+	CHECK_EQ(dev.dup_samples, 0);
+	CHECK_EQ(dev.dirty, 0);		//compensated again
+}
+
+//the driver waits the conversion time instead of polling the status
+static void test_forced_wait(void) {
+	BME280_t dev = {.addr = BME280_ADDR1};
+	uint32_t t;
+
+	setup();
+	CHECK(mock_run(&port, &dev, BME280_Init, 100));
+	dev.config.mode = BME280_FORCED_MODE;	//16x oversampling, about 100 ms
+	bus.transfers = 0;
+	bus.status_reads = 0;
+	CHECK_EQ(BME280_GetDataForced(&port, &dev), 0);	//trigger
+	CHECK(mock_bus_irq(&bus));
+	t = mock_time_us;
+	CHECK_EQ(BME280_GetDataForced(&port, &dev), 0);
+	CHECK_EQ(port.status, PORT_FREE);
+	CHECK_EQ(dev.wait_us, BME280_MeasureTimeMax(dev.config.osrs_t, dev.config.osrs_p, dev.config.osrs_h));
+	mock_advance(dev.wait_us);
+	CHECK(mock_run(&port, &dev, BME280_GetDataForced, 20));
+	CHECK_EQ(dev.wait_us, 0);
+	CHECK_EQ(bus.status_reads, 1);
+	CHECK_EQ(bus.transfers, 3);
+	CHECK(mock_time_us - t >= BME280_MeasureTimeMax(dev.config.osrs_t, dev.config.osrs_p, dev.config.osrs_h));
+	CHECK_EQ(chip.measurements, 1);
+	CHECK(dev.fresh);
+	//a conversion still running is polled again after BME280_STATUS_POLL_US
+	CHECK_EQ(BME280_GetDataForced(&port, &dev), 0);	//trigger
+	CHECK(mock_bus_irq(&bus));
+	CHECK_EQ(BME280_GetDataForced(&port, &dev), 0);	//wait, called again too early
+	CHECK_EQ(BME280_GetDataForced(&port, &dev), 0);	//status
+	CHECK(mock_bus_irq(&bus));
+	CHECK_EQ(BME280_GetDataForced(&port, &dev), 0);
+	CHECK_EQ(dev.wait_us, BME280_STATUS_POLL_US);
+	CHECK_EQ(port.status, PORT_FREE);
+	CHECK(mock_run(&port, &dev, BME280_GetDataForced, 1000));
+	CHECK_EQ(chip.measurements, 2);
+}
+
+//BME280_LogAttach: every new raw sample goes into the ring
+static void test_log_attach(void) {
+	BME280_t dev = {.addr = BME280_ADDR1};
+	bme280_log_entry buf[8];
+	bme280_log_entry e;
+	bme280_log log;
+
+	setup();
+	chip.step.temperature = 16;
+	BME280_LogInit(&log, buf, 8, mock_millis);
+	BME280_LogAttach(&dev, &log);
+	CHECK(mock_run(&port, &dev, BME280_Init, 100));
+	mock_advance(200000);
+	CHECK(mock_run(&port, &dev, BME280_GetData, 10));
+	mock_advance(200000);
+	CHECK(mock_run(&port, &dev, BME280_GetData, 10));
+	CHECK_EQ(BME280_LogCount(&log), 2);
+	CHECK(BME280_LogPop(&log, &e));
+	CHECK(BME280_LogPop(&log, &e));
+	CHECK_EQ(e.raw.temperature, dev.uncomp_data.temperature);
+	BME280_LogAttach(&dev, 0);
+	mock_advance(200000);
+	CHECK(mock_run(&port, &dev, BME280_GetData, 10));
+	CHECK_EQ(BME280_LogCount(&log), 0);
+}
+
+//the status is read after the start-up time of the soft reset, the chip does not answer before
+static void test_recover(void) {
+	BME280_t dev = {.addr = BME280_ADDR1};
+	uint32_t t;
+
+	setup();
+	CHECK(mock_run(&port, &dev, BME280_Init, 100));
+	BME280_Abort(&port, &dev);
+	CHECK_EQ(BME280_Recover(&port, &dev), 0);	//reset
+	CHECK(mock_bus_irq(&bus));
+	t = mock_time_us;
+	CHECK_EQ(BME280_Recover(&port, &dev), 0);
+	CHECK_EQ(dev.wait_us, BME280_STARTUP_US);
+	CHECK_EQ(port.status, PORT_FREE);
+	mock_advance(dev.wait_us);
+	CHECK(mock_run(&port, &dev, BME280_Recover, 20));
+	CHECK(mock_time_us - t >= BME280_STARTUP_US);
+	CHECK_EQ(dev.status, OK);
+	CHECK_EQ(chip.resets, 1);
+	CHECK_EQ(bus.errors, 0);
+	CHECK_EQ(chip.regs[BME280_REG_CTRL_MEAS_PWR], chip.wlog[chip.wlog_len - 1][1]);
+	CHECK_EQ(chip.regs[BME280_REG_CTRL_MEAS_PWR] & BME280_NORMAL_MODE, BME280_NORMAL_MODE);
+}
+
+//replay: frames after a corrupt calibration record are skipped
+static void replay_sample(uint8_t sensor, uint32_t timestamp, BME280_t *dev) {
+	(void)sensor;
+	(void)dev;
+	CHECK(timestamp != 2);
+}
+
+static void test_rec_replay(void) {
+	BME280_t dev = {.addr = BME280_ADDR1};
+	BME280_t out = {.addr = BME280_ADDR1};
+	BME280_t *devs[1] = {&out};
+	uint8_t buf[256];
+	bme280_rec_writer wr;
+	bme280_rec_reader rd;
+	uint32_t calib;
+
+	setup();
+	dev.calib_data = mock_calib_sets[0];
+	BME280_RecInit(&wr, buf, sizeof(buf));
+	CHECK(BME280_RecCalib(&wr, 0, &dev));
+	CHECK(BME280_RecFrame(&wr, 0, 1, &chip.raw));
+	calib = wr.len;
+	CHECK(BME280_RecCalib(&wr, 0, &dev));
+	buf[calib + 2 + 5] ^= 0x01;	//CRC error
+	CHECK(BME280_RecFrame(&wr, 0, 2, &chip.raw));
+	CHECK(BME280_RecCalib(&wr, 0, &dev));
+	CHECK(BME280_RecFrame(&wr, 0, 3, &chip.raw));
+	CHECK(BME280_RecOpen(&rd, buf, wr.len));
+	out.output = BME280_OUTPUT_INT;
+	CHECK_EQ(BME280_RecReplay(&rd, devs, 1, NULL, replay_sample), 2);
+	CHECK(out.calib_cached);
+}
+
+int main(void) {
+	test_port_state();
+	test_init();
+	test_chip_id();
+	test_no_chip();
+	test_normal_read();
+	test_calib_cache();
+	test_calib_verify();
+	test_forced();
+	test_forced_wait();
+	test_log_attach();
+	test_recover();
+	test_rec_replay();
+	return check_result("test_driver");
+}
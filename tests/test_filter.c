@@ -0,0 +1,85 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	test_filter.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+
+#include "check.h"
+#include "BME280_Filter.h"
+
+//an even median length is lowered to the next odd one
+static void test_median_odd(void) {
+	static const int32_t in[] = {10, 1000, 12, 11, -500, 13};
+	static const int32_t out3[] = {10, 1000, 12, 12, 11, 11};	//median of the last 3
+	bme280_filter flt;
+	uint8_t i;
+
+	BME280_FilterInit(&flt, BME280_FILTER_MEDIAN, 4, 0);
+	CHECK_EQ(flt.n, 3);
+	for (i = 0; i < sizeof(in) / sizeof(in[0]); i++) {
+		CHECK_EQ(BME280_FilterChannel(&flt, BME280_CH_PRESSURE, in[i]), out3[i]);
+	}
+	BME280_FilterInit(&flt, BME280_FILTER_MEDIAN, 16, 0);
+	CHECK_EQ(flt.n, BME280_FILTER_MAX_N);
+	BME280_FilterInit(&flt, BME280_FILTER_MEDIAN, 0, 0);
+	CHECK_EQ(flt.n, 1);
+	//the moving average keeps even lengths
+	BME280_FilterInit(&flt, BME280_FILTER_AVERAGE, 4, 0);
+	CHECK_EQ(flt.n, 4);
+}
+
+//IIR step response: the output settles on the input for every shift, a too large shift is lowered
+static void step_response(uint8_t shift, int32_t from, int32_t to) {
+	bme280_filter flt;
+	int32_t acc = from * (1 << BME280_FILTER_IIR_FRAC);
+	int32_t y = 0;
+	int32_t yb = 0;
+	uint32_t i;
+
+	BME280_FilterInit(&flt, BME280_FILTER_IIR, shift, 0);
+	CHECK(flt.n <= BME280_FILTER_IIR_MAX_SHIFT);
+	CHECK_EQ(BME280_FilterChannel(&flt, BME280_CH_PRESSURE, from), from);
+	for (i = 0; i < (32u << flt.n); i++) {
+		y = BME280_FilterChannel(&flt, BME280_CH_PRESSURE, to);
+		BME280_FilterIIRBatch(&acc, &to, &yb, 1, 1, shift);
+		CHECK(from < to ? (y >= from && y <= to) : (y <= from && y >= to));	//no overshoot
+	}
+	CHECK_EQ(y, to);
+	CHECK_EQ(yb, to);
+	//the state is within 1/4 LSB, not just rounded onto the input
+	CHECK(flt.ch[BME280_CH_PRESSURE].acc - to * (1 << BME280_FILTER_IIR_FRAC) <= (1 << (BME280_FILTER_IIR_FRAC - 2)));
+	CHECK(to * (1 << BME280_FILTER_IIR_FRAC) - flt.ch[BME280_CH_PRESSURE].acc <= (1 << (BME280_FILTER_IIR_FRAC - 2)));
+}
+
+static void test_iir_step(void) {
+	uint8_t shift;
+
+	for (shift = 1; shift <= 16; shift++) {
+		step_response(shift, 100000, 100100);
+		step_response(shift, 100100, 100000);
+		step_response(shift, 0, 1);
+		step_response(shift, 1, 0);
+		step_response(shift, -4000, 8500);	//temperature range in 0.01 degC
+	}
+	step_response(16, 30000, 110000);
+}
+
+int main(void) {
+	test_median_odd();
+	test_iir_step();
+	return check_result("test_filter");
+}
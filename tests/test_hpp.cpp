@@ -0,0 +1,198 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	test_hpp.cpp
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+
+#include "check.h"
+#include "mock_port.h"
+#include "BME280.hpp"
+#include <math.h>
+
+/* bme280::Sensor on the simulated port, built with BME280_STATS: the
+ * wrapper runs the C step functions, writes its constant register bytes
+ * and compensates only the selected output. */
+static I2C_Connection port;
+static mock_bus bus;
+static mock_bme280 chip;
+static bme280_transport tr;
+
+static uint32_t clock_us(void) {
+	return mock_time_us;
+}
+
+static void setup(uint8_t type, BME280_t &dev) {
+	mock_bus_init(&bus, &port, type);
+	mock_bme280_init(&chip, BME280_ADDR1, &mock_calib_sets[2]);
+	mock_bus_attach(&bus, &chip);
+	if (type != BME280_BUS_I2C) {
+		tr = mock_bus_transport(&bus);
+		dev.bus = &tr;
+	}
+}
+
+//mock_run for the member functions of the wrapper
+template <class S>
+static uint32_t run(S &s, uint8_t (S::*op)(I2C_Connection *port), uint32_t max_calls) {
+	uint32_t calls;
+
+	for (calls = 1; calls <= max_calls; calls++) {
+		if ((s.*op)(&port)) {
+			return calls;
+		}
+		if (!mock_bus_irq(&bus)) {
+			if (port.status == PORT_BUSY) {
+				return 0;
+			}
+			mock_advance(s.dev().wait_us ? s.dev().wait_us : 100);
+		}
+	}
+	return 0;
+}
+
+//3-wire SPI writes the constant config with spi3w_en before the first read
+template <class S>
+static void check_setup(uint8_t bus_type) {
+	uint8_t pre = (bus_type == BME280_BUS_SPI3);
+	const uint8_t (*wlog)[2] = &chip.wlog[pre];
+
+	if (pre) {
+		CHECK_EQ(chip.wlog[0][0], BME280_REG_CFG);
+		CHECK_EQ(chip.wlog[0][1], S::config);
+	}
+	CHECK_EQ(chip.wlog_len, 4 + pre);
+	CHECK_EQ(wlog[0][1], S::ctrl_meas & ~BME280_NORMAL_MODE);
+	CHECK_EQ(wlog[1][0], BME280_REG_CFG);
+	CHECK_EQ(wlog[1][1], S::config);
+	CHECK_EQ(wlog[2][0], BME280_REG_CTRL_HUM);
+	CHECK_EQ(wlog[2][1], S::ctrl_hum);
+	CHECK_EQ(wlog[3][0], BME280_REG_CTRL_MEAS_PWR);
+	CHECK_EQ(wlog[3][1], S::ctrl_meas);
+}
+
+//C reference of the last sample
+static void reference(const BME280_t &dev, bme280_data_int *ri, bme280_data_float *rf) {
+	bme280::Sensor<BME280_ADDR1, BME280_TEMP_OVERSAMPLING_1X, BME280_PRESS_OVERSAMPLING_1X, BME280_HUM_OVERSAMPLING_1X> ref;
+
+	ref.dev().calib_data = mock_calib_sets[2];
+	ref.dev().uncomp_data = dev.uncomp_data;
+	ref.dev().output = BME280_OUTPUT_BOTH;
+	bme280_prepare_calib_data(&ref.dev());
+	bme280_calculate_data(&ref.dev());
+	*ri = ref.dev().data_int;
+	*rf = ref.dev().data_float;
+}
+
+//normal mode, I2C, int and float from one t_fine
+static void test_normal_both() {
+	typedef bme280::Sensor<BME280_ADDR1, BME280_TEMP_OVERSAMPLING_2X, BME280_PRESS_OVERSAMPLING_16X,
+			BME280_HUM_OVERSAMPLING_1X, BME280_FILTER_COEFF_16, BME280_NORMAL_MODE,
+			BME280_STANDBY_TIME_0_5_MS, BME280_OUTPUT_BOTH> S;
+	S s;
+	bme280_stats st;
+	bme280_data_int ri;
+	bme280_data_float rf;
+
+	static_assert(S::config == (BME280_FILTER_COEFF_16 | BME280_STANDBY_TIME_0_5_MS), "I2C has spi3w_en cleared");
+	setup(BME280_BUS_I2C, s.dev());
+	CHECK(run(s, &S::Init, 100));
+	CHECK_EQ(s.dev().status, OK);
+	check_setup<S>(BME280_BUS_I2C);
+	BME280_StatsReset(&s.dev());
+	mock_advance(100000);
+	CHECK(run(s, &S::GetData, 10));
+	CHECK(s.dev().fresh);
+	BME280_StatsSnapshot(&s.dev(), &st);
+	CHECK_EQ(st.ops, 1);
+	CHECK_EQ(st.transactions, 1);
+	CHECK_EQ(st.bytes, BME280_DATA_LEN);
+	CHECK_EQ(s.dev().dirty, 0);	//t_fine and both outputs done, nothing left for the getters
+	reference(s.dev(), &ri, &rf);
+	CHECK_EQ(s.temperature(), ri.temperature);
+	CHECK_EQ(s.pressure(), ri.pressure);
+	CHECK_EQ(s.humidity(), ri.humidity);
+	CHECK(s.temperature_float() == rf.temperature);
+	CHECK(s.pressure_float() == rf.pressure);
+	CHECK(s.humidity_float() == rf.humidity);
+	CHECK(fabsf(s.temperature_float() * 100.0f - (float)s.temperature()) < 1.0f);
+	//a duplicate frame is not compensated again
+	CHECK(run(s, &S::GetData, 10));
+	CHECK(!s.dev().fresh);
+	CHECK_EQ(bus.misuse, 0);
+}
+
+//forced mode over 3-wire SPI: spi3w_en in the constant config, the C wait step
+static void test_forced_spi3() {
+	typedef bme280::Sensor<BME280_ADDR1, BME280_TEMP_OVERSAMPLING_1X, BME280_PRESS_OVERSAMPLING_1X,
+			BME280_HUM_OVERSAMPLING_OFF, BME280_FILTER_COEFF_OFF, BME280_FORCED_MODE,
+			BME280_STANDBY_TIME_0_5_MS, BME280_OUTPUT_FLOAT, BME280_BUS_SPI3> S;
+	S s;
+	bme280_stats st;
+	bme280_data_int ri;
+	bme280_data_float rf;
+
+	static_assert(S::config & BME280_SPI_3WIRE_MODE_ON, "3-wire SPI sets spi3w_en");
+	setup(BME280_BUS_SPI3, s.dev());
+	CHECK(run(s, &S::Init, 100));
+	check_setup<S>(BME280_BUS_SPI3);
+	CHECK(chip.regs[BME280_REG_CFG] & BME280_SPI_3WIRE_MODE_ON);
+	CHECK_EQ(bus.spi3w_errors, 0);
+	BME280_StatsReset(&s.dev());
+	bus.status_reads = 0;
+	CHECK_EQ(s.GetData(&port), 0);	//trigger
+	CHECK(mock_bus_irq(&bus));
+	CHECK_EQ(s.GetData(&port), 0);	//wait
+	CHECK_EQ(port.status, PORT_FREE);
+	CHECK_EQ(s.dev().wait_us, S::measure_time_max);
+	mock_advance(s.dev().wait_us);
+	CHECK(run(s, &S::GetData, 20));
+	CHECK_EQ(bus.status_reads, 1);
+	CHECK_EQ(chip.measurements, 1);
+	CHECK_EQ(bus.spi_rw_errors, 0);
+	BME280_StatsSnapshot(&s.dev(), &st);
+	CHECK_EQ(st.ops, 1);
+	CHECK_EQ(st.transactions, 3);
+	CHECK_EQ(st.retries, 0);
+	//float output only: the integer data is never written
+	CHECK_EQ(s.dev().data_int.temperature, 0);
+	CHECK_EQ(s.dev().dirty & BME280_DIRTY_FLOAT_T, 0);
+	CHECK(s.dev().dirty & BME280_DIRTY_INT_T);
+	reference(s.dev(), &ri, &rf);
+	CHECK(s.temperature_float() == rf.temperature);
+	CHECK(s.pressure_float() == rf.pressure);
+}
+
+//the constant config does not fit the bus: no transfer
+static void test_bus_mismatch() {
+	typedef bme280::Sensor<BME280_ADDR1, BME280_TEMP_OVERSAMPLING_1X, BME280_PRESS_OVERSAMPLING_1X,
+			BME280_HUM_OVERSAMPLING_1X, BME280_FILTER_COEFF_OFF, BME280_NORMAL_MODE,
+			BME280_STANDBY_TIME_0_5_MS, BME280_OUTPUT_INT, BME280_BUS_SPI3> S;
+	S s;
+
+	setup(BME280_BUS_I2C, s.dev());
+	CHECK_EQ(s.Init(&port), 1);
+	CHECK_EQ(s.dev().error, BME280_ERR_CONFIG);
+	CHECK_EQ(bus.transfers, 0);
+}
+
+int main() {
+	BME280_StatsClock(clock_us);
+	test_normal_both();
+	test_forced_spi3();
+	test_bus_mismatch();
+	return check_result("test_hpp");
+}
@@ -0,0 +1,60 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	test_hpp_gc.cpp
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+
+#include "check.h"
+#include "mock_port.h"
+#include "BME280.hpp"
+
+/* Forced mode, integer output, temperature and pressure only, linked with
+ * --gc-sections: check_symbols.cmake fails the test_hpp_gc_symbols test if
+ * bme280_calculate_data or the compensation of humidity or float output is
+ * in the binary. */
+typedef bme280::Sensor<BME280_ADDR1, BME280_TEMP_OVERSAMPLING_1X, BME280_PRESS_OVERSAMPLING_1X,
+		BME280_HUM_OVERSAMPLING_OFF, BME280_FILTER_COEFF_OFF, BME280_FORCED_MODE> Sensor;
+
+static I2C_Connection port;
+static mock_bus bus;
+static mock_bme280 chip;
+static Sensor sensor;
+
+static uint32_t run(uint8_t (Sensor::*op)(I2C_Connection *port)) {
+	uint32_t calls;
+
+	for (calls = 1; calls <= 100; calls++) {
+		if ((sensor.*op)(&port)) {
+			return calls;
+		}
+		if (!mock_bus_irq(&bus)) {
+			mock_advance(sensor.dev().wait_us ? sensor.dev().wait_us : 100);
+		}
+	}
+	return 0;
+}
+
+int main() {
+	mock_bus_init(&bus, &port, BME280_BUS_I2C);
+	mock_bme280_init(&chip, BME280_ADDR1, &mock_calib_sets[0]);
+	mock_bus_attach(&bus, &chip);
+	CHECK(run(&Sensor::Init));
+	CHECK(run(&Sensor::GetData));
+	CHECK_EQ(sensor.temperature(), 2508);	//datasheet example
+	CHECK(sensor.pressure() > 30000 && sensor.pressure() < 110000);	//Pa
+	return check_result("test_hpp_gc");
+}
@@ -0,0 +1,154 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	test_metrics.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+
+
+#include "check.h"
+#include "BME280_Metrics.h"
+#include <math.h>
+
+/* The fixed point metrics against the same formulas in double over the
+ * sensor range (300-1100 hPa, -40..85 degC, 1-100 %RH, -500 m..9 km), the
+ * max and mean error are reported. Above that the sea level pressure is
+ * checked up to 44330 m for its relative error and the saturation. */
+#define SAMPLES	200000
+
+static uint32_t rnd_state = 2026;
+
+static uint32_t rnd(void) {
+	rnd_state = rnd_state * 1103515245u + 12345u;
+	return rnd_state >> 8;
+}
+
+static int32_t rnd_range(int32_t min, int32_t max) {
+	return min + (int32_t)(rnd() % (uint32_t)(max - min + 1));
+}
+
+//REFERENCE	=====================================================================
+static double ref_altitude(double p, double p0) {
+	return 4433000.0 * (1.0 - pow(p / p0, 0.190263));
+}
+
+static double ref_sea_level(double p, double h) {
+	return p / pow(1.0 - h / 4433000.0, 1.0 / 0.190263);
+}
+
+static double ref_gamma(double t, double rh) {
+	return log(rh / 100.0) + 17.62 * t / (243.12 + t);
+}
+
+static double ref_dew_point(double t, double rh) {
+	double g = ref_gamma(t, rh);
+
+	return 243.12 * g / (17.62 - g);
+}
+
+static double ref_abs_humidity(double t, double rh) {
+	return 216.74 * 6.112 * exp(ref_gamma(t, rh)) / (273.15 + t);
+}
+
+//ERROR	=========================================================================
+typedef struct err_t {
+		const char *name;
+		const char *unit;
+		double bound;		// Max error allowed
+		double max;
+		double sum;
+		uint32_t n;
+} err;
+
+enum {E_ALTITUDE, E_SEA_LEVEL, E_DEW_POINT, E_ABS_HUMIDITY, E_COUNT};
+
+//bounds a bit above the errors seen, about half an LSB of the result each
+static err errs[E_COUNT] = {
+	{"BME280_Altitude", "cm", 0.55, 0, 0, 0},
+	{"BME280_SeaLevelPressure", "Pa", 0.7, 0, 0, 0},
+	{"BME280_DewPoint", "0.01 degC", 0.55, 0, 0, 0},
+	{"BME280_AbsoluteHumidity", "mg/m3", 0.55, 0, 0, 0}
+};
+
+static void add(uint8_t idx, double value, double exact_value) {
+	double d = fabs(value - exact_value);
+
+	errs[idx].max = d > errs[idx].max ? d : errs[idx].max;
+	errs[idx].sum += d;
+	errs[idx].n++;
+}
+
+//TESTS	=========================================================================
+static void test_sensor_range(void) {
+	uint32_t i;
+	uint32_t p, p0, h;
+	int32_t t, alt;
+
+	for (i = 0; i < SAMPLES; i++) {
+		p = (uint32_t)rnd_range(30000, 110000);
+		p0 = (uint32_t)rnd_range(95000, 105000);
+		alt = rnd_range(-50000, 900000);
+		t = rnd_range(-4000, 8500);
+		h = (uint32_t)rnd_range(1024, 102400);
+		add(E_ALTITUDE, BME280_Altitude(p, p0), ref_altitude(p, p0));
+		add(E_SEA_LEVEL, BME280_SeaLevelPressure(p, alt), ref_sea_level(p, alt));
+		add(E_DEW_POINT, BME280_DewPoint(t, h), ref_dew_point(t / 100.0, h / 1024.0) * 100.0);
+		add(E_ABS_HUMIDITY, BME280_AbsoluteHumidity(t, h), ref_abs_humidity(t / 100.0, h / 1024.0) * 1000.0);
+	}
+	printf("%u samples against the double formulas\n", SAMPLES);
+	printf("%-30s %12s %12s %10s\n", "", "max error", "mean error", "bound");
+	for (i = 0; i < E_COUNT; i++) {
+		printf("%-30s %12.6f %12.6f %10.4f %s\n", errs[i].name, errs[i].max, errs[i].sum / errs[i].n,
+				errs[i].bound, errs[i].unit);
+		CHECK(errs[i].max <= errs[i].bound);
+	}
+}
+
+//sea level pressure up to 44330 m: relative error past the rounding, then UINT32_MAX
+static void test_sea_level_high(void) {
+	double rel = 0;
+	double exact, d;
+	uint32_t i;
+	uint32_t p, r;
+	int32_t alt;
+
+	for (i = 0; i < SAMPLES; i++) {
+		p = (uint32_t)rnd_range(100, 110000);
+		alt = rnd_range(900000, 4432999);
+		exact = ref_sea_level(p, alt);
+		r = BME280_SeaLevelPressure(p, alt);
+		if (exact >= 4294967295.0) {
+			CHECK_EQ(r, UINT32_MAX);
+			continue;
+		}
+		d = (fabs(r - exact) - 0.5) / exact;	//without the rounding to 1 Pa
+		rel = d > rel ? d : rel;
+	}
+	printf("%-30s %12.3g relative above 9 km\n", "BME280_SeaLevelPressure", rel);
+	CHECK(rel < 1e-7);
+	CHECK(BME280_SeaLevelPressure(30000, 4000000) > 30000u * 5000u);	//40 km: about 5.3e8 Pa, not 689 Pa
+	CHECK_EQ(BME280_SeaLevelPressure(30000, 4433000), UINT32_MAX);
+	CHECK_EQ(BME280_SeaLevelPressure(101325, INT32_MAX), UINT32_MAX);
+	CHECK_EQ(BME280_SeaLevelPressure(0, 100000), 0);
+	CHECK_EQ(BME280_SeaLevelPressure(101325, 0), 101325);
+	CHECK(BME280_SeaLevelPressure(101325, INT32_MIN) < 101325);
+}
+
+int main(void) {
+	test_sensor_range();
+	test_sea_level_high();
+	return check_result("test_metrics");
+}
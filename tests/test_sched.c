@@ -0,0 +1,150 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	test_sched.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+
+#include "check.h"
+#include "mock_port.h"
+#include "BME280_Sched.h"
+
+static I2C_Connection port;
+static mock_bus bus;
+static mock_bme280 chip[2];
+static BME280_t dev[2] = {{.addr = BME280_ADDR1}, {.addr = BME280_ADDR2}};
+static bme280_sched_entry table[2];
+static bme280_sched sched;
+static uint32_t delivered[2];
+
+static void on_sample(uint8_t idx, BME280_t *d) {
+	(void)d;
+	delivered[idx]++;
+}
+
+static void setup(uint8_t mode) {
+	uint8_t i;
+
+	mock_time_us = 0;
+	mock_bus_init(&bus, &port, BME280_BUS_I2C);
+	for (i = 0; i < 2; i++) {
+		mock_bme280_init(&chip[i], dev[i].addr, &mock_calib_sets[i]);
+		mock_bus_attach(&bus, &chip[i]);
+		chip[i].step.temperature = 16;	//every measurement is a new frame
+		BME280_SetProfile(&dev[i], BME280_PROFILE_DEFAULT);	//16x oversampling
+		dev[i].config.mode = mode;
+		dev[i].step = 0;
+		dev[i].status = INIT;
+		table[i].port = &port;
+		table[i].dev = &dev[i];
+		delivered[i] = 0;
+	}
+	BME280_SchedInit(&sched, table, 2, on_sample, mock_millis);
+}
+
+//main loop: the completion interrupt runs as soon as a transfer is started
+static void run_for(uint32_t ms) {
+	uint32_t end = mock_time_us + ms * 1000;
+
+	while ((int32_t)(mock_time_us - end) < 0) {
+		BME280_SchedRun(&sched);
+		if (!mock_bus_irq(&bus)) {
+			mock_advance(100);
+		}
+	}
+}
+
+//forced sensors release the port during the conversion and keep their sample period
+static void test_forced(void) {
+	uint32_t busy_us = 0;
+	uint32_t end;
+
+	setup(BME280_FORCED_MODE);
+	chip[0].step.temperature = 0;	//stable conditions: equal frames are still new measurements
+	table[0].period_ms = 250;
+	table[1].period_ms = 0;		//BME280_SCHED_FORCED_MS
+	run_for(100);
+	CHECK(table[0].ready && table[1].ready);
+	delivered[0] = delivered[1] = 0;
+	bus.status_reads = 0;
+	end = mock_time_us + 5000 * 1000;
+	while ((int32_t)(mock_time_us - end) < 0) {
+		BME280_SchedRun(&sched);
+		if (table[0].owner || table[1].owner) {
+			busy_us += 100;
+		}
+		if (!mock_bus_irq(&bus)) {
+			mock_advance(100);
+		}
+	}
+	CHECK(delivered[0] >= 19 && delivered[0] <= 21);
+	CHECK(delivered[1] >= 4 && delivered[1] <= 6);
+	CHECK_EQ(chip[0].measurements, table[0].samples);
+	CHECK_EQ(chip[1].measurements, table[1].samples);
+	CHECK(bus.status_reads <= delivered[0] + delivered[1] + 2);	//read once after the conversion time
+	CHECK(busy_us < 5000 * 1000 / 20);	//port held for the transfers only
+	CHECK_EQ(bus.misuse, 0);
+	CHECK_EQ(table[0].dups + table[1].dups, 0);
+}
+
+//normal mode reads are paced by the cycle period
+static void test_normal(void) {
+	uint32_t period = BME280_CyclePeriod(&dev[0].config);
+
+	setup(BME280_NORMAL_MODE);
+	run_for(2000);
+	CHECK(table[0].ready && table[1].ready);
+	CHECK(delivered[0] + 2 >= 2000 * 1000 / period && delivered[0] <= 2000 * 1000 / period + 1);
+	CHECK(table[0].dups < delivered[0]);
+	CHECK_EQ(bus.misuse, 0);
+}
+
+//a hung transfer is stopped in the port driver before the sensor is aborted
+static void test_hang(void) {
+	uint32_t before[2];
+
+	setup(BME280_NORMAL_MODE);
+	sched.port_abort = mock_bus_abort;
+	run_for(200);
+	CHECK(table[0].ready && table[1].ready);
+	bus.hang_next = 1;
+	run_for(500);
+	CHECK_EQ(bus.aborts, 1);
+	CHECK_EQ(bus.misuse, 0);
+	before[0] = delivered[0];
+	before[1] = delivered[1];
+	run_for(1000);
+	CHECK(delivered[0] > before[0] && delivered[1] > before[1]);
+	CHECK_EQ(table[0].dead + table[1].dead, 0);
+	CHECK_EQ(table[0].recover + table[1].recover, 0);	//reset and set up again at the first try
+	CHECK_EQ(chip[0].resets + chip[1].resets, 1);
+	CHECK_EQ(bus.errors, 0);
+	CHECK_EQ(bus.misuse, 0);
+	//without the hook the peripheral still runs the hung transfer
+	setup(BME280_NORMAL_MODE);
+	run_for(200);
+	bus.hang_next = 1;
+	run_for(500);
+	CHECK_EQ(bus.aborts, 0);
+	CHECK(bus.misuse > 0);
+}
+
+int main(void) {
+	test_forced();
+	test_normal();
+	test_hang();
+	return check_result("test_sched");
+}
@@ -0,0 +1,143 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	test_transport.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+
+#include "check.h"
+#include "mock_port.h"
+
+/* The same register map model behind I2C and the two SPI transports of
+ * mock_bus_transport: the SPI side checks bit 7 of every control byte
+ * (set for reads, cleared for writes, also inside the address/data pairs). */
+static I2C_Connection port;
+static mock_bus bus;
+static mock_bme280 chip;
+static bme280_transport tr;
+
+static void setup(uint8_t type, BME280_t *dev) {
+	mock_bus_init(&bus, &port, type);
+	mock_bme280_init(&chip, BME280_ADDR1, &mock_calib_sets[1]);
+	mock_bus_attach(&bus, &chip);
+	tr = mock_bus_transport(&bus);
+	dev->bus = &tr;
+	BME280_SetProfile(dev, BME280_PROFILE_INDOOR_NAV);
+}
+
+//setup is one write: sleep mode first, then config, ctrl_hum and ctrl_meas as address/data pairs.
+//pre: writes logged before it, the last one is the spi3w_en write of 3-wire SPI before the first read
+static void check_setup(const BME280_t *dev, uint8_t spi3w, uint8_t pre) {
+	uint8_t ctrl_meas = dev->config.osrs_t | dev->config.osrs_p | dev->config.mode;
+	uint8_t config = dev->config.filter | dev->config.standby | spi3w;
+	const uint8_t (*wlog)[2] = &chip.wlog[pre];
+
+	if (spi3w && pre) {
+		CHECK_EQ(wlog[-1][0], BME280_REG_CFG);
+		CHECK_EQ(wlog[-1][1], config);
+	}
+	CHECK_EQ(chip.wlog_len, 4 + pre);
+	CHECK_EQ(wlog[0][0], BME280_REG_CTRL_MEAS_PWR);
+	CHECK_EQ(wlog[0][1], ctrl_meas & ~BME280_NORMAL_MODE);
+	CHECK_EQ(wlog[1][0], BME280_REG_CFG);
+	CHECK_EQ(wlog[1][1], config);
+	CHECK_EQ(wlog[2][0], BME280_REG_CTRL_HUM);
+	CHECK_EQ(wlog[2][1], dev->config.osrs_h);
+	CHECK_EQ(wlog[3][0], BME280_REG_CTRL_MEAS_PWR);
+	CHECK_EQ(wlog[3][1], ctrl_meas);
+	CHECK_EQ(chip.regs[BME280_REG_CFG] & BME280_SPI_3WIRE_MODE_ON, spi3w);
+}
+
+static void run_bus(uint8_t type) {
+	BME280_t dev = {.addr = BME280_ADDR1};
+	BME280_t ref = {.addr = BME280_ADDR1};
+	uint8_t spi3w = (type == BME280_BUS_SPI3) ? BME280_SPI_3WIRE_MODE_ON : 0;
+
+	setup(type, &dev);
+	CHECK(mock_run(&port, &dev, BME280_Init, 100));
+	CHECK_EQ(dev.status, OK);
+	check_setup(&dev, spi3w, spi3w ? 1 : 0);
+	mock_advance(100000);
+	CHECK(mock_run(&port, &dev, BME280_GetData, 10));
+	if (type != BME280_BUS_I2C) {
+		CHECK(port.reg & BME280_SPI_READ);		//control byte of the data read
+	}
+	//Configure writes the same pairs again
+	chip.wlog_len = 0;
+	CHECK(mock_run(&port, &dev, BME280_Configure, 10));
+	check_setup(&dev, spi3w, 0);
+	dev.config.mode = BME280_FORCED_MODE;
+	chip.wlog_len = 0;
+	CHECK(mock_run(&port, &dev, BME280_GetDataForced, 100));
+	CHECK_EQ(chip.wlog[0][0], BME280_REG_CTRL_MEAS_PWR);
+	//the soft reset of Recover clears spi3w_en, it is written again before the status read.
+	//SPI polls the NVM copy every few us: up to a few hundred status reads
+	dev.config.mode = BME280_NORMAL_MODE;
+	chip.wlog_len = 0;
+	CHECK(mock_run(&port, &dev, BME280_Recover, 1000));
+	CHECK_EQ(dev.status, OK);
+	CHECK_EQ(chip.resets, 1);
+	CHECK_EQ(chip.wlog[0][0], BME280_REG_RESET);
+	check_setup(&dev, spi3w, spi3w ? 2 : 1);
+	CHECK_EQ(bus.spi_rw_errors, 0);
+	CHECK_EQ(bus.spi3w_errors, 0);
+	CHECK_EQ(bus.errors, 0);
+	CHECK_EQ(bus.misuse, 0);
+	//same calibration and data on every bus
+	ref.calib_data = mock_calib_sets[1];
+	ref.uncomp_data = dev.uncomp_data;
+	bme280_prepare_calib_data(&ref);
+	bme280_calculate_data(&ref);
+	CHECK_EQ(dev.data_int.temperature, ref.data_int.temperature);
+	CHECK_EQ(dev.data_int.pressure, ref.data_int.pressure);
+	CHECK_EQ(dev.data_int.humidity, ref.data_int.humidity);
+}
+
+//3-wire reads return a floating line until spi3w_en is set
+static void test_spi3w_check(void) {
+	BME280_t dev = {.addr = BME280_ADDR1};
+
+	setup(BME280_BUS_SPI3, &dev);
+	port.reg = BME280_REG_CHIP_ID | BME280_SPI_READ;
+	port.len = 1;
+	port.mode = I2C_MODE_READ;
+	tr.start(tr.ctx, &port);
+	CHECK(mock_bus_irq(&bus));
+	CHECK_EQ(bus.spi3w_errors, 1);
+	CHECK_EQ(port.buffer.buf[port.buffer.tail % MOCK_FIFO_LEN], 0xFF);
+}
+
+//the model flags a control byte with the wrong bit 7
+static void test_spi_check(void) {
+	BME280_t dev = {.addr = BME280_ADDR1};
+
+	setup(BME280_BUS_SPI4, &dev);
+	port.reg = BME280_REG_CHIP_ID & ~BME280_SPI_READ;
+	port.len = 1;
+	port.mode = I2C_MODE_READ;
+	tr.start(tr.ctx, &port);
+	CHECK(mock_bus_irq(&bus));
+	CHECK_EQ(bus.spi_rw_errors, 1);
+}
+
+int main(void) {
+	run_bus(BME280_BUS_I2C);
+	run_bus(BME280_BUS_SPI4);
+	run_bus(BME280_BUS_SPI3);
+	test_spi_check();
+	test_spi3w_check();
+	return check_result("test_transport");
+}
@@ -0,0 +1,201 @@
+/*********************************************************************************
+   Original author: Alexandr Pochtovy<alex.mail.prime@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+   
+ 	bme280_rec.c
+	Created on: 16.10.2026
+ ***********************************************************************************/
+
+
+#define _POSIX_C_SOURCE 200809L
+#include "BME280_Record.h"
+#include "mock_bme280.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Host record/replay of BME280_Record streams, timestamps in ms.
+ * gen FILE [frames [sensors]]	synthetic recording for load tests: the
+ *		calibration sets of the chip model, raw frames across the range
+ * replay FILE [-r] [-f] [-q]	maps the file and compensates every frame
+ *		through BME280_RecReplay, CSV sensor,timestamp,T,P,H on stdout:
+ *		-r real time, -f float output instead of int, -q summary only */
+#define REC_SENSORS		3		//calibration sets of the model
+#define REC_MAX_SENSORS	255
+#define REC_CHUNK		65536
+
+static uint8_t quiet;
+static uint8_t use_float;
+static uint32_t first_ts;
+static uint8_t started;
+static struct timespec t0;
+
+static double now_s(void) {
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+static int gen(const char *path, uint32_t frames, uint8_t sensors) {
+	static uint8_t buf[REC_CHUNK];
+	BME280_t dev = {.addr = BME280_ADDR1};
+	bme280_rec_writer wr;
+	bme280_uncomp_data raw;
+	FILE *f = fopen(path, "wb");
+	uint32_t x = 12345;
+	uint32_t i;
+	uint8_t s;
+
+	if (!f) {
+		perror(path);
+		return 1;
+	}
+	BME280_RecInit(&wr, buf, sizeof(buf));
+	for (s = 0; s < sensors; s++) {
+		dev.calib_data = mock_calib_sets[s % REC_SENSORS];
+		BME280_RecCalib(&wr, s, &dev);
+	}
+	for (i = 0; i < frames; i++) {
+		if (wr.len + BME280_REC_FRAME_LEN > wr.size) {
+			fwrite(buf, 1, wr.len, f);
+			BME280_RecClear(&wr);
+		}
+		x = x * 1103515245u + 12345u;
+		raw.temperature = 420000 + (x >> 8) % 200000;
+		raw.pressure = 250000 + (x >> 4) % 200000;
+		raw.humidity = 15000 + (x >> 12) % 30000;
+		BME280_RecFrame(&wr, (uint8_t)(i % sensors), i / sensors * 1000, &raw);
+	}
+	fwrite(buf, 1, wr.len, f);
+	if (fclose(f) != 0) {
+		perror(path);
+		return 1;
+	}
+	return 0;
+}
+
+//real time: sleep until the frame time after the first frame
+static void wait_frame(uint32_t timestamp) {
+	struct timespec t;
+	uint64_t ns;
+
+	if (!started) {
+		started = 1;
+		first_ts = timestamp;
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+	}
+	ns = (uint64_t)t0.tv_sec * 1000000000u + (uint64_t)t0.tv_nsec + (uint64_t)(timestamp - first_ts) * 1000000u;
+	t.tv_sec = (time_t)(ns / 1000000000u);
+	t.tv_nsec = (long)(ns % 1000000000u);
+	clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL);
+}
+
+static void on_sample(uint8_t sensor, uint32_t timestamp, BME280_t *dev) {
+	if (quiet) {
+		return;
+	}
+#ifndef BME280_NO_FLOAT
+	if (use_float) {
+		printf("%u,%u,%.2f,%.2f,%.3f\n", sensor, timestamp, dev->data_float.temperature,
+				dev->data_float.pressure, dev->data_float.humidity);
+		return;
+	}
+#endif
+	printf("%u,%u,%d,%u,%u\n", sensor, timestamp, (int)dev->data_int.temperature,
+			(unsigned)dev->data_int.pressure, (unsigned)dev->data_int.humidity);
+}
+
+static int replay(const char *path, uint8_t realtime) {
+	static BME280_t devs[REC_MAX_SENSORS];
+	BME280_t *dev[REC_MAX_SENSORS];
+	bme280_rec_reader rd;
+	struct stat st;
+	const uint8_t *map;
+	uint32_t cnt;
+	double t;
+	int fd = open(path, O_RDONLY);
+	int i;
+
+	if (fd < 0 || fstat(fd, &st) != 0) {
+		perror(path);
+		return 1;
+	}
+	if (st.st_size == 0 || (uint64_t)st.st_size > UINT32_MAX) {
+		fprintf(stderr, "%s: size is not 1 B..4 GB\n", path);
+		return 1;
+	}
+	map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		perror(path);
+		return 1;
+	}
+	posix_madvise((void *)map, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+	if (!BME280_RecOpen(&rd, map, (uint32_t)st.st_size)) {
+		fprintf(stderr, "%s: not a BME280 recording of version %d\n", path, BME280_REC_VERSION);
+		return 1;
+	}
+	for (i = 0; i < REC_MAX_SENSORS; i++) {
+		devs[i].output = use_float ? BME280_OUTPUT_FLOAT : BME280_OUTPUT_INT;
+		dev[i] = &devs[i];
+	}
+	t = now_s();
+	cnt = BME280_RecReplay(&rd, dev, REC_MAX_SENSORS, realtime ? wait_frame : NULL, on_sample);
+	t = now_s() - t;
+	fprintf(stderr, "%u frames in %.3f s, %.1f ns/frame%s\n", cnt, t, cnt ? t * 1e9 / cnt : 0.0,
+			rd.pos == rd.size ? "" : ", stopped at a truncated or unknown record");
+	munmap((void *)map, (size_t)st.st_size);
+	return rd.pos == rd.size ? 0 : 1;
+}
+
+static int usage(void) {
+	fprintf(stderr, "usage: bme280_rec gen FILE [frames [sensors]]\n"
+			"       bme280_rec replay FILE [-r] [-f] [-q]\n");
+	return 2;
+}
+
+int main(int argc, char **argv) {
+	uint8_t realtime = 0;
+	long sensors;
+	int i;
+
+	if (argc >= 3 && strcmp(argv[1], "gen") == 0) {
+		sensors = argc > 4 ? strtol(argv[4], NULL, 0) : 1;
+		if (argc > 5 || sensors < 1 || sensors > REC_MAX_SENSORS) {
+			return usage();
+		}
+		return gen(argv[2], argc > 3 ? (uint32_t)strtoul(argv[3], NULL, 0) : 1000, (uint8_t)sensors);
+	}
+	if (argc >= 3 && strcmp(argv[1], "replay") == 0) {
+		for (i = 3; i < argc; i++) {
+			if (strcmp(argv[i], "-r") == 0) {
+				realtime = 1;
+			} else if (strcmp(argv[i], "-f") == 0) {
+				use_float = 1;
+			} else if (strcmp(argv[i], "-q") == 0) {
+				quiet = 1;
+			} else {
+				return usage();
+			}
+		}
+		return replay(argv[2], realtime);
+	}
+	return usage();
+}